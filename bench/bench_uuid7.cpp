@@ -0,0 +1,366 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2026 bkwoka
+// Repository: https://github.com/bkwoka/UUIDv7
+
+/*
+ * Native microbenchmarks for the generator and codec.
+ *
+ *   make bench                      # table on stdout
+ *   make bench BENCH_ARGS=--json    # JSON on stdout, for regression tracking
+ *   ./bench_runner --filter codec   # run cases whose name contains "codec"
+ *
+ * Every case runs SAMPLES timed batches of BATCH operations. ns/op is total
+ * time over total operations; p50/p99/max are taken over the per-batch
+ * averages (timing single calls would mostly measure the clock). Heap
+ * allocations are counted through the global operator new.
+ */
+
+#include "BasicUUID7.h"
+#include "UUID7Bulk.h"
+#include "UUID7.h"
+#include "UUID7Codec.h"
+#include "UUID7ISR.h"
+#include "UUID7Index.h"
+#include "UUID7Prefetcher.h"
+#include "UUID7Scanner.h"
+#include "UUID7Sharded.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <string>
+#include <thread>
+#include <vector>
+
+// --- Allocation counting ---
+
+static std::atomic<uint64_t> g_allocs(0);
+
+void *operator new(size_t n) {
+    g_allocs.fetch_add(1, std::memory_order_relaxed);
+    void *p = std::malloc(n ? n : 1);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete(void *p, size_t) noexcept { std::free(p); }
+
+// --- Harness ---
+
+static const int SAMPLES = 2000;
+static const int BATCH = 32;
+
+struct Result {
+    std::string name;
+    int threads;
+    uint64_t ops;
+    double ns_per_op;
+    double p50_ns;
+    double p99_ns;
+    double max_ns;
+    double allocs_per_op;
+};
+
+static volatile uint32_t g_sink = 0;
+static std::vector<Result> g_results;
+static const char *g_filter = nullptr;
+
+static uint64_t now_ns() {
+    using namespace std::chrono;
+    return (uint64_t)duration_cast<nanoseconds>(
+               steady_clock::now().time_since_epoch()).count();
+}
+
+static bool selected(const char *name) {
+    return !g_filter || strstr(name, g_filter) != nullptr;
+}
+
+/** @brief Runs op(thread_index) SAMPLES*BATCH times on each of `threads` threads. */
+template <typename Op>
+static void run(const char *name, Op op, int threads = 1) {
+    if (!selected(name)) return;
+    for (int i = 0; i < BATCH * 16; i++) op(0); // Warm-up
+
+    std::vector<std::vector<double> > samples(threads);
+    std::atomic<int> ready(0);
+    std::atomic<bool> go(false);
+    std::vector<std::thread> pool;
+    uint64_t allocs_before = 0, t0 = 0;
+
+    auto body = [&](int tid) {
+        std::vector<double> &s = samples[tid];
+        s.reserve(SAMPLES);
+        ready.fetch_add(1);
+        while (!go.load(std::memory_order_acquire)) {}
+        for (int i = 0; i < SAMPLES; i++) {
+            uint64_t a = now_ns();
+            for (int j = 0; j < BATCH; j++) op(tid);
+            s.push_back((double)(now_ns() - a) / BATCH);
+        }
+    };
+
+    for (int t = 1; t < threads; t++) pool.push_back(std::thread(body, t));
+    while (ready.load() < threads - 1) {}
+    samples[0].reserve(SAMPLES);
+    allocs_before = g_allocs.load();
+    t0 = now_ns();
+    go.store(true, std::memory_order_release);
+    {
+        std::vector<double> &s = samples[0];
+        for (int i = 0; i < SAMPLES; i++) {
+            uint64_t a = now_ns();
+            for (int j = 0; j < BATCH; j++) op(0);
+            s.push_back((double)(now_ns() - a) / BATCH);
+        }
+    }
+    for (size_t t = 0; t < pool.size(); t++) pool[t].join();
+    uint64_t elapsed = now_ns() - t0;
+    uint64_t allocs = g_allocs.load() - allocs_before;
+
+    std::vector<double> all;
+    for (int t = 0; t < threads; t++)
+        all.insert(all.end(), samples[t].begin(), samples[t].end());
+    std::sort(all.begin(), all.end());
+
+    Result r;
+    r.name = name;
+    r.threads = threads;
+    r.ops = (uint64_t)threads * SAMPLES * BATCH;
+    r.ns_per_op = (double)elapsed / (double)r.ops;
+    r.p50_ns = all[all.size() / 2];
+    r.p99_ns = all[(all.size() * 99) / 100];
+    r.max_ns = all.back();
+    r.allocs_per_op = (double)allocs / (double)r.ops;
+    g_results.push_back(r);
+}
+
+// --- Mock sources ---
+
+static uint64_t s_fixed_ms = 1700000000000ULL;
+static uint64_t fixed_clock(void *) { return s_fixed_ms; }
+
+static uint64_t s_tick_ms = 1700000000000ULL;
+static uint32_t s_tick_calls = 0;
+static uint64_t ticking_clock(void *) {
+    // Advances one millisecond every 64 reads
+    if (++s_tick_calls % 64 == 0) s_tick_ms++;
+    return s_tick_ms;
+}
+
+static uint64_t s_step_ms = 1700000000000ULL;
+static uint64_t stepping_clock(void *) { return s_step_ms++; }
+
+static void saturated_rng(uint8_t *dest, size_t len, void *) {
+    memset(dest, 0xFF, len);
+    if (len) dest[0] = 0xFE; // Pass the RNG health check
+}
+
+static uint64_t s_saved = 0;
+static void null_save(uint64_t ts, void *) { s_saved = ts; }
+static uint64_t null_load(void *) { return 0; }
+
+// --- Output ---
+
+static void print_table() {
+    printf("%-34s %4s %10s %10s %10s %10s %8s\n", "case", "thr", "ns/op",
+           "p50", "p99", "max", "alloc/op");
+    for (size_t i = 0; i < g_results.size(); i++) {
+        const Result &r = g_results[i];
+        printf("%-34s %4d %10.1f %10.1f %10.1f %10.1f %8.3f\n", r.name.c_str(),
+               r.threads, r.ns_per_op, r.p50_ns, r.p99_ns, r.max_ns,
+               r.allocs_per_op);
+    }
+}
+
+static void print_json() {
+    printf("{\n  \"benchmark\": \"uuid7\",\n  \"samples\": %d,\n  \"batch\": %d,\n"
+           "  \"cases\": [\n", SAMPLES, BATCH);
+    for (size_t i = 0; i < g_results.size(); i++) {
+        const Result &r = g_results[i];
+        printf("    {\"name\": \"%s\", \"threads\": %d, \"ops\": %llu, "
+               "\"ns_per_op\": %.2f, \"p50_ns\": %.2f, \"p99_ns\": %.2f, "
+               "\"max_ns\": %.2f, \"allocs_per_op\": %.4f}%s\n",
+               r.name.c_str(), r.threads, (unsigned long long)r.ops,
+               r.ns_per_op, r.p50_ns, r.p99_ns, r.max_ns, r.allocs_per_op,
+               i + 1 < g_results.size() ? "," : "");
+    }
+    printf("  ]\n}\n");
+}
+
+int main(int argc, char **argv) {
+    bool json = false;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--json") == 0) json = true;
+        else if (strcmp(argv[i], "--filter") == 0 && i + 1 < argc) g_filter = argv[++i];
+        else {
+            fprintf(stderr, "usage: %s [--json] [--filter substring]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    // --- Single-thread generate() ---
+    UUID7 v7;
+    run("generate/v7", [&](int) { g_sink += v7.generate(); });
+
+    UUID7 v4;
+    v4.setVersion(UUID_VERSION_4);
+    run("generate/v4", [&](int) { g_sink += v4.generate(); });
+
+    uint8_t v4_buf[64][16];
+    run("generate/v4_batch64_per_id", [&](int) {
+        static int slot = 0;
+        if (slot++ % 64 == 0) g_sink += (uint32_t)v4.generateBatch(v4_buf, 64);
+    });
+
+    UUID7 burst(nullptr, nullptr, fixed_clock, nullptr);
+    run("generate/v7_same_ms", [&](int) { g_sink += burst.generate(); });
+
+    UUID7 tick(nullptr, nullptr, fixed_clock, nullptr);
+    tick.setEntropyMode(UUID_ENTROPY_ON_TICK);
+    run("generate/v7_same_ms_on_tick", [&](int) { g_sink += tick.generate(); });
+
+    UUID7 into;
+    uint8_t buf[16];
+    run("generate/v7_into_buffer", [&](int) { g_sink += into.generate(buf); });
+
+    UUID7 batch;
+    uint8_t batch_buf[16][16];
+    run("generate/v7_batch16_per_id", [&](int) {
+        static int slot = 0;
+        if (slot++ % 16 == 0) g_sink += (uint32_t)batch.generateBatch(batch_buf, 16);
+    });
+
+    UUID7 fail(saturated_rng, nullptr, fixed_clock, nullptr);
+    run("generate/overflow_fail_fast", [&](int) { g_sink += fail.generate(); });
+
+    UUID7 wait(saturated_rng, nullptr, ticking_clock, nullptr);
+    wait.setOverflowPolicy(UUID_OVERFLOW_WAIT);
+    run("generate/overflow_wait", [&](int) { g_sink += wait.generate(); });
+
+    BasicUUID7<uuid7::policy::DefaultRng, uuid7::policy::DefaultClock,
+               uuid7::policy::NoLock> basic;
+    run("generate/basic_nolock", [&](int) { g_sink += basic.generate(); });
+
+#if defined(UUID7_HAS_ATOMIC64)
+    UUID7 lf;
+    lf.setLockFree(true);
+    run("generate/v7_lock_free", [&](int) { g_sink += lf.generate(); });
+#endif
+
+    // --- Persistence callback overhead (a save on every millisecond) ---
+    UUID7 inline_save(nullptr, nullptr, stepping_clock, nullptr);
+    inline_save.setStorage(null_load, null_save, nullptr, 0);
+    run("persistence/inline_every_ms", [&](int) { g_sink += inline_save.generate(); });
+
+    UUID7 deferred_save(nullptr, nullptr, stepping_clock, nullptr);
+    deferred_save.setStorage(null_load, null_save, nullptr, 0);
+    deferred_save.setPersistenceMode(UUID_PERSIST_DEFERRED);
+    run("persistence/deferred_every_ms", [&](int) { g_sink += deferred_save.generate(); });
+
+    UUID7 no_save(nullptr, nullptr, stepping_clock, nullptr);
+    run("persistence/none_every_ms", [&](int) { g_sink += no_save.generate(); });
+
+    // --- Codec ---
+    UUID7 src;
+    (void)src.generate();
+    char str[37];
+    run("codec/encode", [&](int) {
+        g_sink += UUID7Codec::encode(src.data(), str, sizeof(str), false, true);
+    });
+    UUID7Codec::encode(src.data(), str, sizeof(str), false, true);
+    uint8_t out[16];
+    run("codec/decode", [&](int) { g_sink += UUID7Codec::decode(str, out); });
+    char b32[27];
+    run("codec/encode_base32", [&](int) {
+        g_sink += UUID7Codec::encodeBase32(src.data(), b32, sizeof(b32));
+    });
+
+    // --- Scanner: 4 KB of JSON lines, one dashed ID per line ---
+    std::string text;
+    while (text.size() < 4096) {
+        char line[96];
+        UUID7Codec::encode(src.data(), str, sizeof(str), false, true);
+        snprintf(line, sizeof(line), "{\"id\":\"%s\",\"v\":%u,\"tag\":\"beef\"}\n", str,
+                 (unsigned)text.size());
+        text += line;
+    }
+    run("scan/json_4k", [&](int) {
+        UUID7Scanner::Match m[64];
+        g_sink += (uint32_t)UUID7Scanner::scan(text.data(), text.size(), m, 64);
+    });
+
+    // --- Bulk inspection of 1024 stored IDs (per call, not per ID) ---
+    static uint8_t stored[1024][16];
+    UUID7 bulk_gen(nullptr, nullptr, stepping_clock, nullptr);
+    for (int i = 0; i < 1024; i++) g_sink += bulk_gen.generate(stored[i]);
+    static uint64_t stored_ts[1024];
+    run("bulk/timestamps_1024", [&](int) {
+        UUID7Bulk::timestamps(stored, 1024, stored_ts);
+        g_sink += (uint32_t)stored_ts[17];
+    });
+    uint32_t hist[64];
+    uint64_t hist_start = UUID7Bulk::timestamp(stored[0]);
+    run("bulk/histogram_1024", [&](int) {
+        g_sink += (uint32_t)UUID7Bulk::histogram(stored, 1024, hist_start, 16, hist, 64);
+    });
+
+    // --- Interrupt lane ---
+    static UUID7ISR<> isr;
+    uint64_t isr_ms = 1700000000000ULL;
+    uint32_t isr_n = 0;
+    isr.begin(isr_ms);
+    run("isr/generate", [&](int) {
+        if ((isr_n++ & 1023) == 0) isr.tick(++isr_ms); // Stay within the per-ms budget
+        uint8_t id[16];
+        g_sink += isr.generateFromISR(id);
+    });
+
+    // --- Prefetch ring (producer thread refills) ---
+    static UUID7 pf_gen;
+    static UUID7Prefetcher<256> pf(pf_gen);
+    pf.start();
+    run("prefetch/pop", [&](int) {
+        uint8_t id[16];
+        while (!pf.pop(id)) {
+        }
+        g_sink += id[15];
+    });
+    pf.stop();
+
+    // --- Sorted index ---
+    static UUID7Key idx_storage[1 << 16];
+    UUID7Index idx(idx_storage, 1 << 16);
+    UUID7 idx_gen;
+    run("index/insert_in_order", [&](int) {
+        if (idx.size() == idx.capacity()) idx.clear();
+        uint8_t id[16];
+        g_sink += idx_gen.generate(id) && idx.insert(id);
+    });
+    UUID7Key probe = idx[idx.size() / 2];
+    run("index/contains", [&](int) { g_sink += idx.contains(probe); });
+    uint64_t mid_ms = probe.timestamp();
+    run("index/count_between", [&](int) {
+        g_sink += (uint32_t)idx.countBetween(mid_ms, mid_ms + 1);
+    });
+
+    // --- Contention on the shared UUID7Guard ---
+    int hw = (int)std::thread::hardware_concurrency();
+    if (hw < 2) hw = 2;
+    static UUID7 shared;
+    static UUID7Sharded<64> sharded;
+    for (int t = 2; t <= hw && t <= 16; t *= 2) {
+        run("contention/shared_guard", [](int) { g_sink += shared.generate(); }, t);
+        run("contention/sharded", [](int) {
+            uint8_t id[16];
+            g_sink += sharded.generate(id);
+        }, t);
+    }
+
+    if (json) print_json();
+    else print_table();
+    return g_sink == 0xFFFFFFFFu; // Keep the sink observable
+}
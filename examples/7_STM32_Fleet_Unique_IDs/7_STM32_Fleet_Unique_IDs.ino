@@ -59,6 +59,14 @@ void setup() {
     uint64_t entropy_seed = hash96to64(uid0, uid1, uid2);
     uuid.mixEntropy(entropy_seed);
 
+    //    mixEntropy() makes collisions improbable. If every device can be
+    //    given a small fleet number (provisioning, config, a lookup of the
+    //    UID), setNodeId() makes them impossible instead: the number is
+    //    stored in the top bits of rand_b and the counter runs below it.
+    //
+    //    uuid.setNodeId(fleet_number, 14);  // up to 16384 devices
+    //    uuid.setCounterSeedBits(40);       // >= 2^48 - 2^40 IDs per ms
+
     Serial.println("Entropy seed injected from hardware UID.");
     Serial.println("All UUIDs from this device are now globally unique.");
     Serial.println("---");
@@ -90,6 +98,20 @@ void setup() {
     //    - Temporal sortability (from timestamp)
     //    - Spatial uniqueness (from UID)
     //    - Monotonicity (from sub-ms counter)
+
+    // 5. PERSISTENCE ON EMULATED FLASH (optional)
+    //
+    //    With an RTC, add storage so IDs stay unique across reboots. A lease
+    //    reserves a window of time per write instead of writing every few
+    //    seconds; size it to the part's write endurance:
+    //
+    //    uuid.setStorage(flash_load, flash_save, nullptr);
+    //    uuid.setStorageLease(600000UL);  // NOR flash: one write per 10 min
+    //    // uuid.setStorageLease(5000UL); // FRAM: endurance is not a concern
+    //    uuid.load();
+    //
+    //    After a reboot, IDs resume after the stored lease end, skipping at
+    //    most one lease of timestamps.
 }
 
 void loop() {
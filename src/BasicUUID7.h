@@ -0,0 +1,241 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2026 bkwoka
+// Repository: https://github.com/bkwoka/UUIDv7
+
+#pragma once
+
+#include "UUID7.h"
+#include "UUID7Codec.h"
+#include "UUID7Guard.h"
+
+namespace uuid7 {
+namespace policy {
+
+/** @brief Platform RNG (UUID7::default_fill_random). */
+struct DefaultRng {
+  static void fill(uint8_t *dest, size_t len) noexcept {
+    UUID7::default_fill_random(dest, len, nullptr);
+  }
+};
+
+/** @brief Platform clock (UUID7::default_now_ms). */
+struct DefaultClock {
+  static uint64_t now() noexcept { return UUID7::default_now_ms(nullptr); }
+  static uint64_t now_us(void *ctx) noexcept { return UUID7::default_now_us(ctx); }
+};
+
+/** @brief Compile-time bound RNG function (inlinable). */
+template <void (*F)(uint8_t *, size_t, void *)> struct FnRng {
+  static void fill(uint8_t *dest, size_t len) noexcept { F(dest, len, nullptr); }
+};
+
+/** @brief Compile-time bound clock function (inlinable). */
+template <uint64_t (*F)(void *)> struct FnClock {
+  static uint64_t now() noexcept { return F(nullptr); }
+};
+
+/** @brief Process-wide UUID7Guard (same lock as UUID7). */
+struct GuardLock {
+  UUID7Guard guard;
+  GuardLock() : guard(nullptr, nullptr) {}
+};
+
+/** @brief No locking, for single-context use (e.g. only from loop()). */
+struct NoLock {};
+
+/** @brief Persistence disabled; all persistence code compiles away. */
+struct NoPersistence {
+  static constexpr bool enabled = false;
+  static constexpr uint32_t interval_ms = 0;
+  static uint64_t load() noexcept { return 0; }
+  static void save(uint64_t) noexcept {}
+};
+
+/** @brief Periodic persistence through compile-time bound callbacks. */
+template <uuid_load_fn Load, uuid_save_fn Save, uint32_t IntervalMs = 10000>
+struct FnPersistence {
+  static constexpr bool enabled = true;
+  static constexpr uint32_t interval_ms = IntervalMs;
+  static uint64_t load() noexcept { return Load(nullptr); }
+  static void save(uint64_t ts) noexcept { Save(ts, nullptr); }
+};
+
+/** @brief Overflow and regression behaviour. */
+template <UUIDOverflowPolicy Overflow = UUID_OVERFLOW_FAIL_FAST,
+          uint32_t RegressionThresholdMs = 10000>
+struct Behaviour {
+  static constexpr bool wait = Overflow == UUID_OVERFLOW_WAIT;
+  static constexpr uint32_t regression_threshold_ms = RegressionThresholdMs;
+};
+
+} // namespace policy
+} // namespace uuid7
+
+/**
+ * @class BasicUUID7
+ * @brief UUIDv7 generator configured at compile time.
+ *
+ * The RNG, clock, lock, persistence and overflow behaviour are template
+ * policies instead of run-time function pointers and flags, so the hot path
+ * has no indirect calls and unused features (persistence, locking) compile
+ * away. It produces the same layout and monotonicity guarantees as UUID7
+ * (v7 only, 74-bit counter, RFC 9562 v4 fallback on a major clock
+ * regression). UUID7 remains the run-time configurable generator with the
+ * full feature set.
+ *
+ * @code
+ * static uint64_t rtc_ms(void *) { return rtc.now_ms(); }
+ * BasicUUID7<uuid7::policy::DefaultRng, uuid7::policy::FnClock<rtc_ms>,
+ *            uuid7::policy::NoLock> uuid;
+ * @endcode
+ *
+ * @tparam Rng Provides static fill(dest, len).
+ * @tparam Clock Provides static now() in milliseconds (0 = unavailable), and
+ *         optionally now_us(ctx) on the same epoch to phase overflow waits.
+ * @tparam Lock RAII type held around state updates.
+ * @tparam Persistence Provides enabled, interval_ms, load() and save(ts).
+ * @tparam Policy Provides wait and regression_threshold_ms.
+ */
+template <typename Rng = uuid7::policy::DefaultRng,
+          typename Clock = uuid7::policy::DefaultClock,
+          typename Lock = uuid7::policy::GuardLock,
+          typename Persistence = uuid7::policy::NoPersistence,
+          typename Policy = uuid7::policy::Behaviour<>>
+class BasicUUID7 {
+public:
+  BasicUUID7() noexcept : _lastSaved(0) { memset(_b, 0, sizeof(_b)); }
+
+  /**
+   * @brief Generate a new UUID into out (and data()).
+   * @return false on RNG/clock failure or counter overflow (FAIL_FAST).
+   */
+  UUID7_NODISCARD bool generate(uint8_t out[16]) noexcept {
+    uint8_t r[16];
+    Rng::fill(r, 16);
+    uint8_t sum_or = 0, sum_and = 0xFF;
+    for (int i = 0; i < 16; i++) {
+      sum_or |= r[i];
+      sum_and &= r[i];
+    }
+    if (sum_or == 0 || sum_and == 0xFF)
+      return false;
+
+    while (true) {
+      uint64_t now_ms = Clock::now();
+      if (now_ms == 0)
+        return false;
+
+      bool overflow = false;
+      uint64_t ts_to_save = 0;
+      {
+        Lock lock;
+        (void)lock;
+        int cmp = _ts.compare(now_ms);
+        if (cmp < 0) {
+          if (now_ms + Policy::regression_threshold_ms < _ts.get()) {
+            r[6] = (r[6] & 0x0F) | 0x40;
+            r[8] = (r[8] & 0x3F) | 0x80;
+            memcpy(out, r, 16);
+            memcpy(_b, r, 16);
+            return true;
+          }
+          cmp = 0;
+        }
+        if (cmp > 0 || !_ctr.seeded) {
+          if (cmp > 0)
+            _ts.set(now_ms);
+          _ctr.load(r);
+        } else {
+          overflow = !_ctr.add(1);
+        }
+        if (!overflow) {
+          _ctr.store(out);
+          _ts.stampBytes(out);
+          out[6] = (out[6] & 0x0F) | 0x70;
+          out[8] = (out[8] & 0x3F) | 0x80;
+          memcpy(_b, out, 16);
+          if (Persistence::enabled &&
+              _ts.get() > _lastSaved + Persistence::interval_ms) {
+            _lastSaved = _ts.get();
+            ts_to_save = _lastSaved;
+          }
+        }
+      }
+
+      if (Persistence::enabled && ts_to_save)
+        Persistence::save(ts_to_save);
+      if (!overflow)
+        return true;
+      if (!Policy::wait)
+        return false;
+      _backoff();
+    }
+  }
+
+  /** @brief Generate a new UUID into data(). */
+  UUID7_NODISCARD bool generate() noexcept {
+    uint8_t id[16];
+    return generate(id);
+  }
+
+  /** @brief Generate a new UUID into a uuid7::Id. */
+  UUID7_NODISCARD bool generate(uuid7::Id &out) noexcept {
+    return generate(out.b);
+  }
+
+  /** @brief Generate a new UUID by value (uuid7::Id::nil() on failure). */
+  UUID7_NODISCARD uuid7::Id generateId() noexcept {
+    uuid7::Id id;
+    if (!generate(id.b))
+      return uuid7::Id::nil();
+    return id;
+  }
+
+  /**
+   * @brief Load the persisted timestamp and apply the safety jump (see
+   * UUID7::load()). No-op without persistence.
+   */
+  void load() noexcept {
+    if (!Persistence::enabled)
+      return;
+    uint64_t saved = Persistence::load();
+    if (saved == 0)
+      return;
+    Lock lock;
+    (void)lock;
+    _lastSaved = saved;
+    _ts.set(saved + Persistence::interval_ms);
+    _ctr.seeded = false;
+  }
+
+  /** @brief Format the last generated UUID (see UUID7::toString()). */
+  bool toString(char *out, size_t buflen, bool uppercase = false,
+                bool dashes = true) const noexcept {
+    uint8_t snap[16];
+    {
+      Lock lock;
+      (void)lock;
+      memcpy(snap, _b, 16);
+    }
+    return UUID7Codec::encode(snap, out, buflen, uppercase, dashes);
+  }
+
+  /** @brief Raw bytes of the last generated UUID. */
+  const uint8_t *data() const noexcept { return _b; }
+
+private:
+  uint8_t _b[16];
+  TimestampState _ts;
+  UUID7Counter _ctr;
+  uint64_t _lastSaved;
+
+  // Clocks that expose now_us (DefaultClock) phase the overflow sleep.
+  template <class C> static UUID7::now_us_fn _usClock(decltype(&C::now_us)) noexcept {
+    return &C::now_us;
+  }
+  template <class C> static UUID7::now_us_fn _usClock(...) noexcept { return nullptr; }
+
+  static void _backoff() noexcept {
+    UUID7::retryBackoff(true, _usClock<Clock>(nullptr), nullptr);
+  }
+};
@@ -23,6 +23,11 @@ inline void yield() {}
 /**
  * @class EasyUUID7
  * @brief High-level wrapper for UUIDv7 with automatic string caching and retry logic.
+ *
+ * The string cache is filled lazily: generate(), parse() and fromBytes()
+ * only mark it stale, and the 36 characters are formatted on the first
+ * toCharArray() / c_str() afterwards. Callers that only use data() pay
+ * nothing for the string layer.
  * @warning Do not use polymorphically via UUID7* pointers or UUID7& references,
  * as the base generate() method is not virtual (to save RAM/Flash).
  */
@@ -30,35 +35,49 @@ class EasyUUID7 final : public UUID7 {
 private:
   char _cacheBuffer[37]; // String representation cache
   uint16_t _max_retries; // Maximum generation attempts before failure
-  bool _initialized;     // Tracks if a valid UUID is currently cached
+  bool _initialized;     // Tracks if a valid UUID is currently held
+  bool _cacheDirty;      // _cacheBuffer lags behind the held UUID
+
+  /** @brief Format the held UUID into the cache if it is stale. */
+  char *_refresh() {
+    if (_cacheDirty) {
+      UUID7::toString(_cacheBuffer, sizeof(_cacheBuffer));
+      _cacheDirty = false;
+    }
+    return _cacheBuffer;
+  }
 
 public:
   explicit EasyUUID7(uint16_t max_retries = 100)
-      : UUID7(), _max_retries(max_retries), _initialized(false) {
+      : UUID7(), _max_retries(max_retries), _initialized(false),
+        _cacheDirty(false) {
     memset(_cacheBuffer, 0, sizeof(_cacheBuffer));
   }
 
   /**
    * @brief Generates a new UUID.
    * BLOCKING CALL: Will retry until successful or max_retries is reached.
-   * Automatically updates the internal string cache.
+   * Marks the string cache stale; it is re-formatted on the next read.
    * @return true if successful, false if max_retries exceeded (e.g., hardware
    * failure).
    */
   UUID7_NODISCARD bool generate() {
     uint16_t tries = 0;
 
-    // Spin-wait until successful or limit reached.
+    // Retry until successful or limit reached. A FAIL_FAST overflow clears
+    // on the next millisecond, so sleep to the tick; anything else yields.
     while (!UUID7::generate()) {
       if (++tries >= _max_retries) {
         return false; // Prevent infinite loop in case of recurrent hardware failure
       }
-      yield();
+      if (_failedOnOverflow())
+        _sleepToNextTick();
+      else
+        UUID7::retryBackoff(false, nullptr, nullptr);
     }
 
-    // Update cache immediately
-    UUID7::toString(_cacheBuffer, sizeof(_cacheBuffer));
     _initialized = true;
+    _cacheDirty = true;
     return true;
   }
 
@@ -70,8 +89,8 @@ public:
   bool parse(const char *str36) noexcept {
     bool ok = UUID7::parse(str36);
     if (ok) {
-      UUID7::toString(_cacheBuffer, sizeof(_cacheBuffer));
       _initialized = true;
+      _cacheDirty = true;
     }
     return ok;
   }
@@ -82,8 +101,8 @@ public:
    */
   void fromBytes(const uint8_t bytes[16]) noexcept {
     UUID7::fromBytes(bytes);
-    UUID7::toString(_cacheBuffer, sizeof(_cacheBuffer));
     _initialized = true;
+    _cacheDirty = true;
   }
 
   /**
@@ -101,17 +120,41 @@ public:
         return _cacheBuffer;
       }
     }
-    return _cacheBuffer;
+    return _refresh();
+  }
+
+  /**
+   * @brief Zero-copy view of the cached 36-character string (lazy, like
+   * toCharArray()). Valid until the next generate()/parse()/fromBytes().
+   */
+  const char *c_str() { return toCharArray(); }
+
+  /**
+   * @brief Format the held UUID into a caller buffer without a String.
+   * @param out Destination (>= 37 bytes dashed, >= 33 without dashes).
+   * @return false if the buffer is too small.
+   */
+  bool toCharArray(char *out, size_t buflen, bool uppercase = false,
+                   bool dashes = true) const noexcept {
+    if (!uppercase && dashes && !_cacheDirty && _initialized) {
+      if (buflen < sizeof(_cacheBuffer))
+        return false;
+      memcpy(out, _cacheBuffer, sizeof(_cacheBuffer));
+      return true;
+    }
+    return UUID7::toString(out, buflen, uppercase, dashes);
   }
 
   /**
    * @brief Returns Arduino String object with optional formatting.
+   * Allocates on every call; prefer c_str() or toCharArray(out, len) on
+   * heap-constrained targets.
    * @param uppercase If true, uses UPPERCASE hex.
    * @param dashes If false, omits hyphens.
    */
   String toString(bool uppercase = false, bool dashes = true) const {
     char buf[37];
-    UUID7::toString(buf, sizeof(buf), uppercase, dashes);
+    toCharArray(buf, sizeof(buf), uppercase, dashes);
     return String(buf);
   }
 
@@ -121,8 +164,8 @@ public:
   operator String() const { return toString(); }
 
   // Allows: const char* s = uuid;
-  // Note: NON-CONST to allow lazy generation if the buffer is empty.
-  operator const char *() { return toCharArray(); }
+  // Note: NON-CONST to allow lazy generation and cache refresh.
+  operator const char *() { return c_str(); }
 
   /**
    * @brief Parse a 36-character UUID from an Arduino String.
@@ -7,6 +7,16 @@
 #include "UUID7Guard.h"
 #include <string.h>
 
+#define UUID7_TS_MASK 0x0000FFFFFFFFFFFFULL
+
+#if defined(UUID7_ENABLE_STATS)
+#define UUID7_STAT(field) UUID7Stats::add(&_stats.field)
+#define UUID7_STAT_N(field, n) UUID7Stats::add(&_stats.field, (uint32_t)(n))
+#else
+#define UUID7_STAT(field) ((void)0)
+#define UUID7_STAT_N(field, n) ((void)0)
+#endif
+
 #if defined(PLATFORMIO_ESP32) || defined(ARDUINO_ARCH_ESP32)
 portMUX_TYPE _uuid_spinlock = portMUX_INITIALIZER_UNLOCKED;
 #elif defined(ARDUINO_ARCH_RP2040) && defined(PICO_SDK_VERSION_MAJOR)
@@ -18,6 +28,7 @@ __attribute__((constructor)) static void _uuid_init_spinlock() {
   }
 }
 #elif defined(PLATFORMIO_NATIVE)
+#include <chrono>
 #include <thread>
 std::mutex _uuid_mutex;
 static inline void yield() { std::this_thread::yield(); }
@@ -31,12 +42,18 @@ static inline void yield() {}
 
 UUID7::UUID7(fill_random_fn rng, void *rng_ctx, now_ms_fn now,
              void *now_ctx) noexcept
-    : _version(UUID_VERSION_7), _overflowPolicy(UUID_OVERFLOW_FAIL_FAST),
-      _rng(rng),
+    : _pubSeq(0), _version(UUID_VERSION_7), _overflowPolicy(UUID_OVERFLOW_FAIL_FAST),
+      _entropyMode(UUID_ENTROPY_EVERY_CALL), _rng(rng),
       // Provide instance context to static RNG function for accessing fallback entropy parameters
       _rng_ctx(rng ? rng_ctx : this), _now(now), _now_ctx(now_ctx),
+      _now_us(nullptr), _now_us_ctx(nullptr), _subMs(false), _clockPinned(false),
+      _overflowed(false),
+      _seedBits(74), _incBits(0),
       _entropy_mixer(0),
-      _regressionThresholdMs(10000), _lock_cb(nullptr), _unlock_cb(nullptr) {
+      _regressionThresholdMs(10000), _overflowTimeoutMs(0), _lock_cb(nullptr), _unlock_cb(nullptr),
+      _lock_ctx_cb(nullptr), _unlock_ctx_cb(nullptr), _lock_ctx(nullptr),
+      _nodeBits(0), _nodeId(0), _shardBits(0), _shardId(0), _prefixBits(0),
+      _prefix(0) {
   memset(_b, 0, sizeof(_b));
 
 #if defined(ARDUINO_ARCH_AVR) || defined(__AVR__)
@@ -49,6 +66,11 @@ UUID7::UUID7(fill_random_fn rng, void *rng_ctx, now_ms_fn now,
 #else
   _entropyAnalogPin = -1;
 #endif
+
+#if defined(UUID7_HAS_ATOMIC64)
+  _lfState = 0;
+  _lockFree = false;
+#endif
 }
 
 void UUID7::setVersion(UUIDVersion v) { _version = v; }
@@ -61,219 +83,722 @@ void UUID7::setStorage(uuid_load_fn load_fn, uuid_save_fn save_fn, void *ctx,
   _persistence.interval_ms = auto_save_interval_ms;
 }
 
+void UUID7::setStorageLease(uint32_t lease_ms, uint32_t margin_ms) {
+  if (margin_ms > lease_ms / 2)
+    margin_ms = lease_ms / 2;
+  _persistence.lease_ms = lease_ms;
+  _persistence.margin_ms = margin_ms;
+}
+
 void UUID7::load() {
   if (_persistence.load) {
     uint64_t saved_ts = _persistence.load(_persistence.ctx);
     if (saved_ts > 0) {
+      uint64_t target = _persistence.resumeFrom(saved_ts);
       _persistence.last_saved_ms = saved_ts;
-      uint64_t target = saved_ts + _persistence.interval_ms;
+      _persistence.flushed_ms = saved_ts;
+      _persistence.pending_ms = saved_ts;
+      if (_persistence.deferred) {
+        // Publish the jump target (or the next lease) so that a
+        // flushStorage() in setup() extends the safe window before the
+        // first generate().
+        uint64_t next = target;
+        if (_persistence.lease_ms) {
+          next += _persistence.lease_ms;
+          _persistence.last_saved_ms = next;
+        }
+        _persistence.pending_ms = next;
+      }
 
       _tsState.set(target);
+      _ctr.seeded = false;
+#if defined(UUID7_HAS_ATOMIC64)
+      uuid7::atomic::store(&_lfState, (target & UUID7_TS_MASK) << 16);
+#endif
     }
   }
 }
 
 
 
-bool UUID7::_incrementRandom() noexcept {
-  // Continuously increment the random section, respecting variant/version boundaries.
-  for (int i = 15; i >= 9; i--) {
-    if (++_b[i] != 0)
-      return true;
+// Fail-fast for hardware faults (all 0x00 or all 0xFF).
+static inline bool uuid_rng_fault(const uint8_t r[16]) {
+#if defined(UUID7_OPTIMIZE_SIZE)
+  uint8_t sum_or = 0;
+  uint8_t sum_and = 0xFF;
+  for (int i = 0; i < 16; i++) {
+    sum_or |= r[i];
+    sum_and &= r[i];
   }
+  return sum_or == 0 || sum_and == 0xFF;
+#else
+  uint64_t a, b;
+  memcpy(&a, r, 8);
+  memcpy(&b, r + 8, 8);
+  return (a | b) == 0 || (a & b) == ~0ULL;
+#endif
+}
 
-  // Increment byte 8 (variant byte), preserving RFC variant flags (10x)
-  uint8_t b8 = _b[8] & 0x3F;
-  b8++;
-  _b[8] = (_b[8] & 0xC0) | (b8 & 0x3F);
-  if ((b8 & 0x40) == 0)
-    return true; // No overflow if carry didn't reach bit 6
+// Unconditionally mix entropy (XOR with 0 is a no-op, avoids branching)
+static inline void uuid_mix_entropy(uint8_t b[16], uint64_t mixer) {
+#if !defined(UUID7_OPTIMIZE_SIZE) && defined(__BYTE_ORDER__) &&                \
+    (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+  // Byte i takes bits 8i..8i+7 of the mixer, i.e. its little-endian layout.
+  uint64_t w;
+  memcpy(&w, b + 8, 8);
+  w ^= mixer;
+  memcpy(b + 8, &w, 8);
+#else
+  for (int i = 0; i < 8; i++) {
+    b[8 + i] ^= (uint8_t)(mixer >> (i * 8));
+  }
+#endif
+}
 
+static inline void uuid_overflow_backoff() {
+#if defined(ARDUINO)
+  delay(1); // RTOS context yielding to prevent thread starvation during constraint resolution
+#else
+  yield();
+#endif
+}
 
-  if (++_b[7] != 0)
-    return true;
+// Bounded sleep of less than one millisecond.
+static inline void uuid_sleep_us(uint32_t us) {
+#if defined(ARDUINO)
+  // Sub-tick sleeps are below the FreeRTOS tick, so a short busy wait is
+  // the bounded option here; it makes no RNG or clock calls.
+  delayMicroseconds(us);
+#elif defined(PLATFORMIO_NATIVE)
+  std::this_thread::sleep_for(std::chrono::microseconds(us));
+#else
+  (void)us;
+#endif
+}
 
-  // Increment byte 6 (version byte), preserving UUID version flags (0111)
-  uint8_t b6 = _b[6] & 0x0F;
-  b6++;
-  _b[6] = (_b[6] & 0xF0) | (b6 & 0x0F);
+void UUID7::retryBackoff(bool overflow, now_us_fn us_func, void *ctx) noexcept {
+  // Only an overflow is cured by the next tick; RNG or clock failures are
+  // retried as soon as other tasks have had the CPU.
+  if (!overflow) {
+    yield();
+    return;
+  }
+  if (!us_func) {
+    uuid_overflow_backoff();
+    return;
+  }
+  uint64_t now_us = us_func(ctx);
+  uuid_sleep_us(1000 - (uint32_t)(now_us % 1000));
+}
 
-  if ((b6 & 0x10) == 0)
-    return true; // No overflow if carry didn't reach bit 4
+void UUID7::_sleepToNextTick() noexcept {
+  retryBackoff(true, _now_us ? _now_us : (_now ? nullptr : &UUID7::default_now_us),
+               _now_us_ctx);
+}
 
-  return false;
+bool UUID7::_overflowWait(uint64_t now_ms, uint64_t &deadline_ms) noexcept {
+  if (_overflowTimeoutMs) {
+    if (deadline_ms == 0)
+      deadline_ms = now_ms + _overflowTimeoutMs;
+    else if (now_ms >= deadline_ms)
+      return false;
+  }
+  UUID7_STAT(wait_spins);
+  _sleepToNextTick();
+  return true;
+}
+
+// Seed the counter from fresh entropy for a new millisecond (or sub-ms step).
+static inline void uuid_seed_counter(UUID7Counter &ctr, const uint8_t b[16],
+                                     uint8_t seed_bits, uint8_t prefix_bits,
+                                     uint32_t prefix, int16_t frac) {
+  ctr.load(b);
+  ctr.truncate(seed_bits);
+  if (prefix_bits)
+    ctr.setTop(prefix_bits, prefix);
+  if (frac >= 0)
+    ctr.setRandA((uint16_t)frac);
 }
-bool UUID7::generate() {
-  fill_random_fn rng = _rng ? _rng : &UUID7::default_fill_random;
 
-  if (_version == UUID_VERSION_4) {
-    uint8_t temp_rand[16];
-    rng(temp_rand, sizeof(temp_rand), _rng_ctx);
-    uint8_t sum_or = 0;
-    uint8_t sum_and = 0xFF;
-    for (size_t i = 0; i < sizeof(temp_rand); i++) {
-      sum_or |= temp_rand[i];
-      sum_and &= temp_rand[i];
+UUID7::StepResult UUID7::_stepLocked(uint64_t now_ms, int16_t frac,
+                                     const uint8_t *rand, uint8_t dst[16],
+                                     bool &overflow_state) noexcept {
+  int cmp = _tsState.compare(now_ms);
+
+  if (cmp < 0) {
+    if (now_ms + _regressionThresholdMs < _tsState.get()) {
+      if (!rand)
+        return STEP_NEED_ENTROPY;
+      // Major regression detected: initiate RFC9562 fallback (UUIDv4) to guarantee collision resistance.
+      // We intentionally do NOT update _persistence here, as the saved timestamp
+      // is still the correct high-water mark.
+      if (dst != rand)
+        memcpy(dst, rand, 16);
+      uuid_mix_entropy(dst, _entropy_mixer);
+      dst[6] = (dst[6] & 0x0F) | 0x40; // v4 bits
+      dst[8] = (dst[8] & 0x3F) | 0x80; // variant bits
+      UUID7_STAT(v4_fallbacks);
+      return STEP_FALLBACK_V4;
     }
-    if (sum_or == 0 || sum_and == 0xFF)
-      return false; // Fail-fast for hardware faults (all 0x00 or all 0xFF)
+    // Minor regression or race condition: clamp strictly to the last monotonic state
+    cmp = 0; // Evaluate as intra-millisecond progression
+    frac = -1;
+    UUID7_STAT(clock_clamps);
+  }
 
-    // Unconditionally mix entropy (XOR with 0 is a no-op, avoids branching)
-    for (int i = 0; i < 8; i++) {
-      temp_rand[8 + i] ^= (uint8_t)(_entropy_mixer >> (i * 8));
+  bool initialized = _ctr.seeded;
+  // Sub-millisecond mode: a later fraction within the same millisecond
+  // starts a fresh random tail instead of bumping the counter.
+  bool frac_advanced =
+      cmp == 0 && frac >= 0 && initialized && frac > (int16_t)_ctr.randA();
+
+  if (cmp > 0 || frac_advanced) {
+    if (!rand)
+      return STEP_NEED_ENTROPY;
+    _tsState.set(now_ms);
+    if (dst != rand)
+      memcpy(dst, rand, 16);
+    uuid_mix_entropy(dst, _entropy_mixer);
+    uuid_seed_counter(_ctr, dst, _seedBits, _prefixBits, _prefix, frac);
+    overflow_state = false;
+  } else if (overflow_state) {
+    return STEP_OVERFLOW;
+  } else if (!initialized) {
+    // Not yet initialized (e.g. right after load()): seed from fresh entropy.
+    if (!rand)
+      return STEP_NEED_ENTROPY;
+    if (dst != rand)
+      memcpy(dst, rand, 16);
+    uuid_mix_entropy(dst, _entropy_mixer);
+    uuid_seed_counter(_ctr, dst, _seedBits, _prefixBits, _prefix, frac);
+  } else {
+    // Increment internal counter for same-millisecond monotonicity. On
+    // overflow (or a carry into the node/shard prefix) the counter keeps its
+    // value.
+    uint32_t step = 1;
+    if (_incBits && rand) {
+      uint32_t r = ((uint32_t)rand[12] << 24) | ((uint32_t)rand[13] << 16) |
+                   ((uint32_t)rand[14] << 8) | rand[15];
+      step += r & ((1UL << _incBits) - 1);
+    }
+    UUID7Counter next = _ctr;
+    if (!next.add(step) ||
+        (_prefixBits && next.top(_prefixBits) != _prefix)) {
+      overflow_state = true;
+      return STEP_OVERFLOW;
     }
+    _ctr = next;
+  }
 
-    temp_rand[6] = (temp_rand[6] & 0x0F) | 0x40; // Set UUID version to 4 (Random)
-    temp_rand[8] = (temp_rand[8] & 0x3F) | 0x80; // Set variant to RFC 4122 (10b)
+  _ctr.store(dst);
+  _tsState.stampBytes(dst);
+  dst[6] = (dst[6] & 0x0F) | ((uint8_t)_version << 4);
+  dst[8] = (dst[8] & 0x3F) | 0x80;
+  return STEP_OK;
+}
 
-    UUID7Guard lock(_lock_cb, _unlock_cb);
-    memcpy(_b, temp_rand, 16);
-    return true;
+bool UUID7::generate() {
+  uint8_t id[16];
+  if (generateBatch(&id, 1) != 1)
+    return false;
+  bool publish = _version == UUID_VERSION_4;
+#if defined(UUID7_HAS_ATOMIC64)
+  publish = publish || _lockFree;
+#endif
+  if (publish) {
+    // The v4 and lock-free cores leave publication to the caller.
+    UUID7Guard lock(_lock_cb, _unlock_cb, _lock_ctx_cb, _unlock_ctx_cb, _lock_ctx);
+    _publishLocked(id);
   }
+  return true;
+}
 
+bool UUID7::flushStorage(bool force) {
+  if (!_persistence.save)
+    return false;
+  uint64_t ts;
+  {
+#if !defined(UUID7_HAS_ATOMIC64)
+    UUID7Guard lock(_lock_cb, _unlock_cb, _lock_ctx_cb, _unlock_ctx_cb, _lock_ctx);
+#endif
+    ts = _persistence.due(force ? 0 : _persistence.flushGap());
+  }
+  if (ts == 0)
+    return false;
+  _persistence.save(ts, _persistence.ctx);
+  UUID7_STAT(saves);
+  {
+#if !defined(UUID7_HAS_ATOMIC64)
+    UUID7Guard lock(_lock_cb, _unlock_cb, _lock_ctx_cb, _unlock_ctx_cb, _lock_ctx);
+#endif
+    _persistence.markFlushed(ts);
+  }
+  return true;
+}
+
+bool UUID7::isStoragePending() const {
+#if !defined(UUID7_HAS_ATOMIC64)
+  UUID7Guard lock(_lock_cb, _unlock_cb, _lock_ctx_cb, _unlock_ctx_cb, _lock_ctx);
+#endif
+  return _persistence.due(0) != 0;
+}
+
+uint64_t UUID7::_readClock(int16_t &frac) noexcept {
+  frac = -1;
+  // Sub-millisecond mode needs a microsecond clock on the same epoch: an
+  // explicit one, or the platform clock when the default ms clock is in use.
+  now_us_fn us_func = nullptr;
+  if (_subMs)
+    us_func = _now_us ? _now_us : (_now ? nullptr : &UUID7::default_now_us);
+  if (us_func) {
+    uint64_t now_us = us_func(_now_us_ctx);
+    frac = (int16_t)(((now_us % 1000) << 12) / 1000);
+    return now_us / 1000;
+  }
   now_ms_fn now_func = _now ? _now : &UUID7::default_now_ms;
-  bool overflow_state = false;
+  return now_func(_now_ctx);
+}
 
-  while (true) {
-    uint8_t temp_rand[16];
-    rng(temp_rand, sizeof(temp_rand), _rng_ctx);
-
-    uint8_t sum_or = 0;
-    uint8_t sum_and = 0xFF;
-    for (size_t i = 0; i < sizeof(temp_rand); i++) {
-      sum_or |= temp_rand[i];
-      sum_and &= temp_rand[i];
+size_t UUID7::generateBatch(uint8_t (*out)[16], size_t n) {
+#if defined(UUID7_ENABLE_STATS)
+  uint32_t t0 = UUID7Stats::ticks();
+  size_t done = _generateBatch(out, n);
+  _stats.record(done, UUID7Stats::ticks() - t0);
+  return done;
+#else
+  return _generateBatch(out, n);
+#endif
+}
+
+size_t UUID7::_generateBatch(uint8_t (*out)[16], size_t n) {
+  __atomic_store_n(&_overflowed, false, __ATOMIC_RELAXED);
+  if (!out || n == 0)
+    return 0;
+
+  fill_random_fn rng = _rng ? _rng : &UUID7::default_fill_random;
+
+  bool on_tick =
+      _entropyMode == UUID_ENTROPY_ON_TICK && _version == UUID_VERSION_7;
+#if defined(UUID7_HAS_ATOMIC64)
+  on_tick = on_tick && !_lockFree;
+#endif
+
+  if (!on_tick) {
+    // One RNG call for the whole batch: every slot doubles as the entropy
+    // source of the UUID that is later written back into it.
+    rng(out[0], n * 16, _rng_ctx);
+    for (size_t i = 0; i < n; i++) {
+      if (uuid_rng_fault(out[i])) {
+        UUID7_STAT(rng_faults);
+        return 0;
+      }
     }
-    if (sum_or == 0 || sum_and == 0xFF)
-      return false; // Fail-fast for hardware faults (all 0x00 or all 0xFF)
+  }
 
+  if (_version == UUID_VERSION_4)
+    return _generateBatchV4(out, n);
+
+#if defined(UUID7_HAS_ATOMIC64)
+  if (_lockFree)
+    return _generateBatchLockFree(out, n);
+#endif
+
+  bool overflow_state = false;
+  uint64_t deadline_ms = 0;
+  size_t done = 0;
+  uint8_t seed[16];
+  bool have_seed = false;
+
+  while (true) {
     // Retrieve current timestamp before acquiring the lock to avoid deadlocks 
     // strictly with multi-threaded/blocking time providers.
-    uint64_t now_ms = now_func(_now_ctx);
-    if (now_ms == 0)
-      return false;
+    int16_t frac;
+    uint64_t now_ms = _readClock(frac);
+    if (now_ms == 0) {
+      UUID7_STAT(clock_failures);
+      return done;
+    }
 
     bool save_needed = false;
+    bool need_entropy = false;
     uint64_t ts_to_save = 0;
-    bool success = false;
-    bool overflow_occurred = false;
+    size_t end;
 
     {
       // Enforce exclusivity with RAII guard
-      UUID7Guard lock(_lock_cb, _unlock_cb);
+      UUID7Guard lock(_lock_cb, _unlock_cb, _lock_ctx_cb, _unlock_ctx_cb, _lock_ctx);
+      size_t first = done;
+      // Bounded hold: the guard masks interrupts on several targets.
+      end = n - done > UUID7_BATCH_LOCK_SPAN ? done + UUID7_BATCH_LOCK_SPAN : n;
+
+      for (; done < end; done++) {
+        const uint8_t *rand = on_tick ? (have_seed ? seed : nullptr) : out[done];
+        StepResult r =
+            _stepLocked(now_ms, frac, rand, out[done], overflow_state);
+        if (r == STEP_OVERFLOW)
+          break;
+        if (r == STEP_NEED_ENTROPY) {
+          need_entropy = true;
+          break;
+        }
+        have_seed = false;
+        if (r == STEP_OK) {
+          uint64_t ts = _persistence.claim(_tsState.get());
+          if (ts) {
+            save_needed = true;
+            ts_to_save = ts;
+          }
+        }
+      }
+      if (done > first)
+        _publishLocked(out[done - 1]);
+    }
 
-      // Unconditionally mix entropy (XOR with 0 is a no-op, avoids branching)
-      for (int i = 0; i < 8; i++) {
-        temp_rand[8 + i] ^= (uint8_t)(_entropy_mixer >> (i * 8));
+    if (save_needed) {
+      _persistence.save(ts_to_save, _persistence.ctx);
+      UUID7_STAT(saves);
+    }
+    if (done == n)
+      return n;
+    if (done == end)
+      continue; // Span done: release point for waiting interrupts and tasks
+
+    if (need_entropy) {
+      // ON_TICK: the millisecond changed, draw outside the lock and retry.
+      rng(seed, 16, _rng_ctx);
+      if (uuid_rng_fault(seed)) {
+        UUID7_STAT(rng_faults);
+        return done;
       }
+      have_seed = true;
+      continue;
+    }
 
-      int cmp = _tsState.compare(now_ms);
-      bool major_regression = false;
+    UUID7_STAT(overflows);
+    if (_overflowPolicy == UUID_OVERFLOW_FAIL_FAST ||
+        !_overflowWait(now_ms, deadline_ms)) {
+      __atomic_store_n(&_overflowed, true, __ATOMIC_RELAXED);
+      return done;
+    }
+  }
+}
 
-      if (cmp < 0) {
-        if (now_ms + _regressionThresholdMs < _tsState.get()) {
-          major_regression = true;
-        } else {
-          // Minor regression or race condition: clamp strictly to the last monotonic state
-          now_ms = _tsState.get();
-          cmp = 0; // Evaluate as intra-millisecond progression
-        }
-      }
+bool UUID7::reserve(size_t n, UUID7Range &out) {
+#if defined(UUID7_ENABLE_STATS)
+  uint32_t t0 = UUID7Stats::ticks();
+  bool ok = _reserve(n, out);
+  _stats.record(out._n, UUID7Stats::ticks() - t0);
+  return ok;
+#else
+  return _reserve(n, out);
+#endif
+}
+
+bool UUID7::_reserve(size_t n, UUID7Range &out) {
+  out._n = 0;
+  __atomic_store_n(&_overflowed, false, __ATOMIC_RELAXED);
+  if (n == 0 || (uint64_t)n > 0xFFFFFFFFULL || _version != UUID_VERSION_7)
+    return false;
+#if defined(UUID7_HAS_ATOMIC64)
+  if (_lockFree)
+    return false;
+#endif
+
+  fill_random_fn rng = _rng ? _rng : &UUID7::default_fill_random;
+  bool overflow_state = false;
+  uint64_t deadline_ms = 0;
+  uint8_t rand[16];
+  bool need_draw = true;
 
-      if (major_regression) {
-        // Major regression detected: initiate RFC9562 fallback (UUIDv4) to guarantee collision resistance.
-        // We intentionally do NOT update _persistence here, as the saved timestamp
-        // is still the correct high-water mark.
-        temp_rand[6] = (temp_rand[6] & 0x0F) | 0x40; // v4 bits
-        temp_rand[8] = (temp_rand[8] & 0x3F) | 0x80; // variant bits
-        memcpy(_b, temp_rand, 16);
-        return true;
+  while (true) {
+    // Entropy is only redrawn once a step has consumed it.
+    if (need_draw) {
+      rng(rand, 16, _rng_ctx);
+      if (uuid_rng_fault(rand)) {
+        UUID7_STAT(rng_faults);
+        return false;
       }
+      need_draw = false;
+    }
+    int16_t frac;
+    uint64_t now_ms = _readClock(frac);
+    if (now_ms == 0) {
+      UUID7_STAT(clock_failures);
+      return false;
+    }
 
-      if (cmp > 0) {
-        _tsState.set(now_ms);
-        memcpy(_b, temp_rand, 16);
-        success = true;
-        overflow_state = false;
-      } else {
-        if (overflow_state) {
-          overflow_occurred = true;
+    bool ok = false;
+    uint64_t ts_to_save = 0;
+    {
+      UUID7Guard lock(_lock_cb, _unlock_cb, _lock_ctx_cb, _unlock_ctx_cb, _lock_ctx);
+      StepResult r =
+          _stepLocked(now_ms, frac, rand, out._first, overflow_state);
+      if (r == STEP_FALLBACK_V4)
+        return false;
+      if (r == STEP_OK) {
+        need_draw = true;
+        // The first ID took counter value c; claim c+1..c+n-1 on top of it.
+        UUID7Counter last = _ctr;
+        if (last.add((uint32_t)(n - 1)) &&
+            (!_prefixBits || last.top(_prefixBits) == _prefix)) {
+          out._ctr = _ctr;
+          _ctr = last;
+          uint8_t tail[16];
+          memcpy(tail, out._first, 16);
+          last.store(tail);
+          _publishLocked(tail);
+          ts_to_save = _persistence.claim(_tsState.get());
+          ok = true;
         } else {
-          bool initialized = (_b[6] & 0xF0) == 0x70;
-          if (!initialized) {
-            memcpy(_b, temp_rand, 16);
-            success = true;
-          } else {
-            // Increment internal counter for same-millisecond monotonicity.
-            if (!_incrementRandom()) {
-              overflow_occurred = true;
-              overflow_state = true;
-            } else {
-              success = true;
-            }
-          }
+          overflow_state = true;
         }
       }
+    }
 
-      if (success) {
-        _tsState.stampBytes(_b);
-      }
-      if (success && _persistence.save &&
-          (now_ms > _persistence.last_saved_ms + _persistence.interval_ms)) {
-        save_needed = true;
-        _persistence.last_saved_ms = now_ms;
-        ts_to_save = now_ms;
-      }
+    if (ts_to_save) {
+      _persistence.save(ts_to_save, _persistence.ctx);
+      UUID7_STAT(saves);
+    }
+    if (ok) {
+      out._n = n;
+      return true;
+    }
+    UUID7_STAT(overflows);
+    if (_overflowPolicy == UUID_OVERFLOW_FAIL_FAST ||
+        !_overflowWait(now_ms, deadline_ms)) {
+      __atomic_store_n(&_overflowed, true, __ATOMIC_RELAXED);
+      return false;
+    }
+  }
+}
+
+size_t UUID7::_generateBatchV4(uint8_t (*out)[16], size_t n) noexcept {
+  // v4 has no monotonic state: only the mixer is shared.
+  uint64_t mixer;
+#if defined(UUID7_HAS_ATOMIC64)
+  mixer = uuid7::atomic::loadRelaxed(&_entropy_mixer);
+#else
+  {
+    UUID7Guard lock(_lock_cb, _unlock_cb, _lock_ctx_cb, _unlock_ctx_cb, _lock_ctx);
+    mixer = _entropy_mixer;
+  }
+#endif
+  for (size_t i = 0; i < n; i++) {
+    uuid_mix_entropy(out[i], mixer);
+    out[i][6] = (out[i][6] & 0x0F) | 0x40; // Set UUID version to 4 (Random)
+    out[i][8] = (out[i][8] & 0x3F) | 0x80; // Set variant to RFC 4122 (10b)
+  }
+  return n;
+}
+
+#if defined(UUID7_HAS_ATOMIC64)
+// Lock-free layout: 16-bit sequence in rand_a (12 bits) and the top 4 bits of
+// rand_b, below it 58 bits of (mixed) entropy.
+static inline void uuid_stamp_packed(uint8_t b[16], uint64_t ms, uint16_t seq,
+                                     uint64_t mixer, uint8_t prefix_bits,
+                                     uint32_t prefix) {
+  uuid_mix_entropy(b, mixer);
+  if (prefix_bits) {
+    // Node/shard prefix directly below the 4 sequence bits of rand_b.
+    UUID7Counter c;
+    c.load(b);
+    c.setTop((uint8_t)(4 + prefix_bits), prefix);
+    c.store(b);
+  }
+  for (int i = 5; i >= 0; i--) {
+    b[i] = (uint8_t)(ms & 0xFF);
+    ms >>= 8;
+  }
+  b[6] = 0x70 | (uint8_t)((seq >> 12) & 0x0F);
+  b[7] = (uint8_t)(seq >> 4);
+  b[8] = 0x80 | (uint8_t)((seq & 0x0F) << 2) | (b[8] & 0x03);
+}
 
-      if (success) {
-        _b[6] = (_b[6] & 0x0F) | ((uint8_t)_version << 4);
-        _b[8] = (_b[8] & 0x3F) | 0x80;
+size_t UUID7::_generateBatchLockFree(uint8_t (*out)[16], size_t n) noexcept {
+  now_ms_fn now_func = _now ? _now : &UUID7::default_now_ms;
+  uint64_t mixer = uuid7::atomic::loadRelaxed(&_entropy_mixer);
+  uint64_t deadline_ms = 0;
+  size_t done = 0;
+
+  while (true) {
+    uint64_t now_ms = now_func(_now_ctx);
+    if (now_ms == 0) {
+      UUID7_STAT(clock_failures);
+      return done;
+    }
+    now_ms &= UUID7_TS_MASK;
+
+    // Reserve a run of sequence numbers with a single CAS.
+    uint64_t old = uuid7::atomic::load(&_lfState);
+    uint64_t first = 0;
+    size_t count = 0;
+    bool major_regression = false;
+    while (true) {
+      uint64_t last_ms = old >> 16;
+      uint64_t avail;
+      if (now_ms > last_ms) {
+        first = now_ms << 16;
+        avail = 0x10000;
+      } else if (now_ms + _regressionThresholdMs < last_ms) {
+        major_regression = true;
+        break;
+      } else {
+        // Same millisecond or minor regression: continue after the last seq.
+        if (now_ms < last_ms)
+          UUID7_STAT(clock_clamps);
+        first = old + 1;
+        avail = 0xFFFF - (old & 0xFFFF);
       }
+      count = (n - done < avail) ? n - done : (size_t)avail;
+      if (count == 0)
+        break;
+      if (uuid7::atomic::cas(&_lfState, old, first + count - 1))
+        break;
     }
 
-    if (success) {
-      if (save_needed && _persistence.save) {
-        _persistence.save(ts_to_save, _persistence.ctx);
+    if (major_regression) {
+      // Same RFC9562 v4 fallback as the locked generator.
+      UUID7_STAT_N(v4_fallbacks, n - done);
+      for (; done < n; done++) {
+        uuid_mix_entropy(out[done], mixer);
+        out[done][6] = (out[done][6] & 0x0F) | 0x40;
+        out[done][8] = (out[done][8] & 0x3F) | 0x80;
       }
-      return true;
+      return n;
     }
 
-    if (overflow_occurred) {
-      if (_overflowPolicy == UUID_OVERFLOW_FAIL_FAST) {
-        return false;
-      } else {
-#if defined(ARDUINO)
-        delay(1); // RTOS context yielding to prevent thread starvation during constraint resolution
-#else
-        yield();
-#endif
-        continue;
+    if (count == 0) {
+      UUID7_STAT(overflows);
+      if (_overflowPolicy == UUID_OVERFLOW_FAIL_FAST ||
+          !_overflowWait(now_ms, deadline_ms)) {
+        __atomic_store_n(&_overflowed, true, __ATOMIC_RELAXED);
+        return done;
       }
+      continue;
     }
-    return false;
+
+    uint64_t ms = first >> 16;
+    uint16_t seq = (uint16_t)(first & 0xFFFF);
+    for (size_t k = 0; k < count; k++) {
+      uuid_stamp_packed(out[done + k], ms, (uint16_t)(seq + k), mixer,
+                        _prefixBits, _prefix);
+    }
+    done += count;
+
+    uint64_t ts = _persistence.claimAtomic(ms);
+    if (ts) {
+      _persistence.save(ts, _persistence.ctx);
+      _persistence.markFlushed(ts);
+      UUID7_STAT(saves);
+    }
+    if (done == n)
+      return n;
+  }
+}
+#endif
+
+void UUID7::setLockFree(bool enable) noexcept {
+#if defined(UUID7_HAS_ATOMIC64)
+  UUID7Guard lock(_lock_cb, _unlock_cb, _lock_ctx_cb, _unlock_ctx_cb, _lock_ctx);
+  if (enable == _lockFree)
+    return;
+  // Hand the high-water mark over one millisecond ahead so that no ID from
+  // the new representation can sort before one already issued.
+  if (enable) {
+    uint64_t ms = _tsState.get() & UUID7_TS_MASK;
+    uuid7::atomic::store(&_lfState, (ms + 1) << 16);
+  } else {
+    _tsState.set((uuid7::atomic::load(&_lfState) >> 16) + 1);
   }
+  _lockFree = enable;
+#else
+  (void)enable;
+#endif
+}
+
+bool UUID7::getStats(UUID7Stats &out) const noexcept {
+#if defined(UUID7_ENABLE_STATS)
+  _stats.snapshot(out);
+  return true;
+#else
+  out.clear();
+  return false;
+#endif
+}
+
+void UUID7::resetStats() noexcept {
+#if defined(UUID7_ENABLE_STATS)
+  _stats.reset();
+#endif
+}
+
+bool UUID7::isLockFree() const noexcept {
+#if defined(UUID7_HAS_ATOMIC64)
+  return _lockFree;
+#else
+  return false;
+#endif
+}
+
+void UUID7::_publishLocked(const uint8_t id[16]) noexcept {
+#if defined(UUID7_HAS_SEQLOCK)
+  uuid7::seqlock::write(&_pubSeq, _b, id, 16);
+#else
+  memcpy(_b, id, 16);
+#endif
+}
+
+void UUID7::_snapshot(uint8_t out[16]) const noexcept {
+#if defined(UUID7_HAS_SEQLOCK)
+  // A reader can only keep failing if it preempted a writer on the same
+  // core; fall back to the guard, which waits for that writer.
+  if (uuid7::seqlock::read(&_pubSeq, _b, out, 16, 4))
+    return;
+#endif
+  UUID7Guard lock(_lock_cb, _unlock_cb, _lock_ctx_cb, _unlock_ctx_cb, _lock_ctx);
+  memcpy(out, _b, 16);
+}
+
+uint8_t UUID7::_readByte(int i) const noexcept {
+#if defined(UUID7_HAS_SEQLOCK)
+  return uuid7::seqlock::loadByte(&_b[i]);
+#else
+  UUID7Guard lock(_lock_cb, _unlock_cb, _lock_ctx_cb, _unlock_ctx_cb, _lock_ctx);
+  return _b[i];
+#endif
 }
 
 bool UUID7::toString(char *out, size_t buflen, bool uppercase,
                      bool dashes) const noexcept {
   uint8_t local_b[16];
-  {
-    UUID7Guard lock(_lock_cb, _unlock_cb);
-    memcpy(local_b, _b, 16);
-  }
+  _snapshot(local_b);
   return UUID7Codec::encode(local_b, out, buflen, uppercase, dashes);
 }
 
+bool UUID7::toBase32(char *out, size_t buflen) const noexcept {
+  uint8_t local_b[16];
+  _snapshot(local_b);
+  return UUID7Codec::encodeBase32(local_b, out, buflen);
+}
+
+bool UUID7::toBase64Url(char *out, size_t buflen) const noexcept {
+  uint8_t local_b[16];
+  _snapshot(local_b);
+  return UUID7Codec::encodeBase64Url(local_b, out, buflen);
+}
+
 bool UUID7::parseFromString(const char *str, uint8_t out[16]) noexcept {
   return UUID7Codec::decode(str, out);
 }
 
+bool UUID7::parseFromString(const char *str, size_t len,
+                            uint8_t out[16]) noexcept {
+  return UUID7Codec::decode(str, len, out);
+}
+
 uint64_t UUID7::getTimestamp() const noexcept {
   uint8_t snap[16];
-  {
-    UUID7Guard lock(_lock_cb, _unlock_cb);
-    memcpy(snap, _b, 16);
-  }
+  _snapshot(snap);
   if (((snap[6] >> 4) & 0x0F) != 7)
     return 0;
     
@@ -284,41 +809,75 @@ uint64_t UUID7::getTimestamp() const noexcept {
   return ts;
 }
 
-bool UUID7::isV7() const noexcept {
-  uint8_t b6;
-  {
-    UUID7Guard lock(_lock_cb, _unlock_cb);
-    b6 = _b[6];
+uint64_t UUID7::getTimestampMicros() const noexcept {
+  uint8_t snap[16];
+  _snapshot(snap);
+  if (((snap[6] >> 4) & 0x0F) != 7)
+    return 0;
+
+  uint64_t ts = 0;
+  for (int i = 0; i < 6; i++) {
+    ts = (ts << 8) | snap[i];
   }
+  // Inverse of the floor(us * 4096 / 1000) scaling used by generate().
+  uint32_t frac = ((uint32_t)(snap[6] & 0x0F) << 8) | snap[7];
+  return ts * 1000 + (frac * 1000 + 4095) / 4096;
+}
+
+bool UUID7::isV7() const noexcept {
+  uint8_t b6 = _readByte(6);
   return ((b6 >> 4) & 0x0F) == 7;
 }
 
 bool UUID7::isV4() const noexcept {
-  uint8_t b6;
-  {
-    UUID7Guard lock(_lock_cb, _unlock_cb);
-    b6 = _b[6];
-  }
+  uint8_t b6 = _readByte(6);
   return ((b6 >> 4) & 0x0F) == 4;
 }
 
 uint8_t UUID7::getVariant() const noexcept {
-  uint8_t b8;
-  {
-    UUID7Guard lock(_lock_cb, _unlock_cb);
-    b8 = _b[8];
-  }
+  uint8_t b8 = _readByte(8);
   return (b8 >> 6) & 0x03;
 }
 
 void UUID7::mixEntropy(uint64_t seed) noexcept {
-  UUID7Guard lock(_lock_cb, _unlock_cb);
+  UUID7Guard lock(_lock_cb, _unlock_cb, _lock_ctx_cb, _unlock_ctx_cb, _lock_ctx);
+#if defined(UUID7_HAS_ATOMIC64)
+  uuid7::atomic::store(&_entropy_mixer, seed);
+#else
   _entropy_mixer = seed;
+#endif
+}
+
+bool UUID7::setNodeId(uint32_t id, uint8_t bits) noexcept {
+  if (bits > 28 || (id >> bits) != 0)
+    return false;
+  UUID7Guard lock(_lock_cb, _unlock_cb, _lock_ctx_cb, _unlock_ctx_cb, _lock_ctx);
+  if (bits + _shardBits > 28)
+    return false;
+  uint32_t old_id = _nodeId;
+  uint8_t old_bits = _nodeBits;
+  _nodeBits = bits;
+  _nodeId = bits ? id : 0;
+  _updatePrefix();
+  if (old_id == _nodeId && old_bits == _nodeBits)
+    return true;
+  // The next counter seed carries the new prefix and may sort below the
+  // last issued ID; restart one millisecond ahead, as setLockFree() does.
+  if (_ctr.seeded) {
+    _tsState.set(_tsState.get() + 1);
+    _ctr.seeded = false;
+  }
+#if defined(UUID7_HAS_ATOMIC64)
+  uint64_t lf = uuid7::atomic::load(&_lfState);
+  if (lf)
+    uuid7::atomic::store(&_lfState, ((lf >> 16) + 1) << 16);
+#endif
+  return true;
 }
 
 void UUID7::fromBytes(const uint8_t bytes[16]) noexcept {
-  UUID7Guard lock(_lock_cb, _unlock_cb);
-  memcpy(_b, bytes, 16);
+  UUID7Guard lock(_lock_cb, _unlock_cb, _lock_ctx_cb, _unlock_ctx_cb, _lock_ctx);
+  _publishLocked(bytes);
 }
 
 bool UUID7::parse(const char *str36) noexcept {
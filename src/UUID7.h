@@ -22,8 +22,23 @@
 #define UUID7_OPTIMIZE_SIZE
 #endif
 
+// Most IDs generateBatch() steps per UUID7Guard hold. The guard masks
+// interrupts on ESP32, AVR, STM32 and ESP8266, so this bounds how long a
+// batch delays them; bigger batches take the guard once per span.
+#ifndef UUID7_BATCH_LOCK_SPAN
+#if defined(ARDUINO_ARCH_AVR) || defined(__AVR__)
+#define UUID7_BATCH_LOCK_SPAN 4
+#else
+#define UUID7_BATCH_LOCK_SPAN 32
+#endif
+#endif
+
 #include "UUID7Persistence.h"
 #include "TimestampState.h"
+#include "UUID7Counter.h"
+#include "UUID7Range.h"
+#include "UUID7Stats.h"
+#include "UUID7Id.h"
 
 #include <string.h>
 
@@ -51,8 +66,9 @@
 /**
  * @warning Copying a UUID7 object copies its monotonicity state (_tsState).
  * Two copies driven independently will produce UUIDs that may compare
- * less-than each other — violating K-sortability. Use copies only as
- * read-only snapshots (comparison, serialization), never as separate generators.
+ * less-than each other — violating K-sortability. Never drive copies as
+ * separate generators; to store or compare IDs, keep uuid7::Id values
+ * (see generateId() and id()) instead of UUID7 objects.
  */
 #if defined(ARDUINO)
 class UUID7 : public Printable {
@@ -62,11 +78,13 @@ class UUID7 {
 public:
   typedef uuid7::fill_random_fn fill_random_fn;
   typedef uuid7::now_ms_fn now_ms_fn;
+  typedef uuid7::now_us_fn now_us_fn;
 
   typedef uuid7::uuid_save_fn uuid_save_fn;
   typedef uuid7::uuid_load_fn uuid_load_fn;
 
   typedef uuid7::lock_fn_t lock_fn_t;
+  typedef uuid7::lock_ctx_fn lock_ctx_fn;
 
   /**
    * @brief Set custom threshold for clock regression (default: 10000 ms).
@@ -88,6 +106,20 @@ public:
     bool both = (lock_cb != nullptr) && (unlock_cb != nullptr);
     _lock_cb = both ? lock_cb : nullptr;
     _unlock_cb = both ? unlock_cb : nullptr;
+    _lock_ctx_cb = _unlock_ctx_cb = nullptr;
+    _lock_ctx = nullptr;
+  }
+
+  /**
+   * @brief Inject lock/unlock callbacks that take a context pointer, e.g. a
+   * per-object mutex or spinlock (replaces the context-free pair).
+   */
+  void setLockCallbacks(lock_ctx_fn lock_cb, lock_ctx_fn unlock_cb, void *ctx) {
+    bool both = (lock_cb != nullptr) && (unlock_cb != nullptr);
+    _lock_ctx_cb = both ? lock_cb : nullptr;
+    _unlock_ctx_cb = both ? unlock_cb : nullptr;
+    _lock_ctx = both ? ctx : nullptr;
+    _lock_cb = _unlock_cb = nullptr;
   }
 
   /**
@@ -111,12 +143,48 @@ public:
    * Useful if the clock (RTC/NTP) is initialized after the UUID object.
    * @param now Pointer to millisecond time function.
    * @param ctx User context (optional).
+   * @note Ignored on the shards of a UUID7Sharded, whose clock carries the
+   *       shared high-water mark; use UUID7Sharded::setTimeProvider().
    */
   void setTimeProvider(now_ms_fn now, void *ctx = nullptr) {
+    if (_clockPinned)
+      return;
     _now = now;
     _now_ctx = ctx;
   }
 
+  /**
+   * @brief Enable sub-millisecond timestamp precision (RFC 9562, 6.2 Method 3).
+   *
+   * The 12 bits of rand_a carry the fraction of the current millisecond
+   * (microseconds scaled to 0..4095), so IDs within one millisecond are
+   * ordered by time and only IDs within the same ~244 ns step touch the
+   * counter. The time is read from the microsecond provider, which replaces
+   * the millisecond provider while the mode is on.
+   * @note Uses default_now_us() unless setPrecisionTimeProvider() was called.
+   *       If only a custom millisecond provider is configured, the mode stays
+   *       inactive (rand_a remains random). Ignored in the lock-free mode.
+   * @param enable true to enable.
+   */
+  void setSubMillisecondPrecision(bool enable) { _subMs = enable; }
+
+  /** @brief Check if sub-millisecond precision is enabled. */
+  bool getSubMillisecondPrecision() const { return _subMs; }
+
+  /**
+   * @brief Configure the microsecond clock used in sub-millisecond mode.
+   * @param now_us Function returning microseconds on the same epoch as the
+   *        millisecond provider would (Unix epoch for wall-clock IDs).
+   * @param ctx User context (optional).
+   * @note Ignored on UUID7Sharded shards (see setTimeProvider()).
+   */
+  void setPrecisionTimeProvider(now_us_fn now_us, void *ctx = nullptr) {
+    if (_clockPinned)
+      return;
+    _now_us = now_us;
+    _now_us_ctx = ctx;
+  }
+
   void setRandomSource(fill_random_fn rng, void *ctx = nullptr) {
     _rng = rng;
     _rng_ctx = rng ? ctx : this;
@@ -139,6 +207,39 @@ public:
    */
   void mixEntropy(uint64_t seed) noexcept;
 
+  /**
+   * @brief Reserve the top bits of rand_b for a fixed node ID (v7 only).
+   *
+   * Unlike mixEntropy(), this makes IDs from different nodes disjoint by
+   * construction: two nodes with distinct IDs can never emit the same UUID,
+   * whatever their clocks and RNGs do. The same-millisecond counter runs in
+   * the 62 - bits rand_b bits below the node ID (fewer under UUID7Sharded,
+   * whose shard index sits directly below the node ID); a carry into the
+   * node ID is a counter overflow (UUIDOverflowPolicy applies). Lock-free
+   * mode stores the node ID below its 16-bit sequence instead.
+   *
+   * The per-millisecond budget depends on the counter seed: with
+   * setCounterSeedBits(s) and s < 62 - bits, at least
+   * 2^(62 - bits) - 2^s IDs fit in every millisecond (14 node bits and
+   * s = 40: about 2.8e14). With the default full-width seed the budget is
+   * random, 2^(61 - bits) on average.
+   *
+   * @param id Node ID (HAL_GetUIDw*, MAC, configuration); must fit in bits.
+   * @param bits Width of the node ID, 1..28 (0 removes it). Node and shard
+   *        bits together may not exceed 28.
+   * @return false if the arguments do not fit (configuration unchanged).
+   * @note v4 IDs, including the major-regression fallback, stay fully random.
+   * @note Changing the node ID after IDs were issued advances the monotonic
+   *       state by one millisecond, like setLockFree().
+   */
+  bool setNodeId(uint32_t id, uint8_t bits) noexcept;
+
+  /** @brief Configured node ID width in bits (0 if none). */
+  uint8_t getNodeBits() const noexcept { return _nodeBits; }
+
+  /** @brief Configured node ID. */
+  uint32_t getNodeId() const noexcept { return _nodeId; }
+
   /**
    * @brief Get current configured UUID version.
    * @warning After a major clock regression, the generator temporarily falls back 
@@ -168,10 +269,12 @@ public:
    *       for an all-zero buffer, and for UUIDs of other versions (v1, v3, v5)
    *       loaded via fromBytes() or parseFromString(), as this library only
    *       generates and recognises v4 and v7.
-   * @warning This is a convenience method that calls isV7() and isV4() sequentially.
-   *          In multi-threaded environments, it performs up to two independent lock cycles.
+   * @note Reads the version nibble once (a single synchronized read).
    */
-  bool isValid() const noexcept { return isV7() || isV4(); }
+  bool isValid() const noexcept {
+    uint8_t v = _readByte(6) >> 4;
+    return v == 7 || v == 4;
+  }
 
   /**
    * @brief Extract the 48-bit Unix timestamp (milliseconds) from the UUID.
@@ -179,6 +282,15 @@ public:
    */
   uint64_t getTimestamp() const noexcept;
 
+  /**
+   * @brief Extract the timestamp in microseconds, including the 12-bit
+   * sub-millisecond fraction (see setSubMillisecondPrecision()).
+   * @return Timestamp in microseconds, or 0 if the UUID is not Version 7.
+   * @note Only meaningful for IDs generated with sub-millisecond precision;
+   *       otherwise the fraction part is random.
+   */
+  uint64_t getTimestampMicros() const noexcept;
+
   /**
    * @brief Parse a UUID string directly into this object.
    * Supports both 36-character (dashed) and 32-character (undashed) formats.
@@ -203,6 +315,67 @@ public:
    */
   UUIDOverflowPolicy getOverflowPolicy() const { return _overflowPolicy; }
 
+  /**
+   * @brief Bound how long UUID_OVERFLOW_WAIT may block (default 0: no limit).
+   * While waiting, the generator sleeps until the next millisecond tick
+   * instead of spinning; once timeout_ms of clock time have passed since the
+   * first overflow, the call gives up and returns false as under FAIL_FAST.
+   * @param timeout_ms Deadline in milliseconds, 0 to wait indefinitely.
+   */
+  void setOverflowTimeout(uint32_t timeout_ms) {
+    _overflowTimeoutMs = timeout_ms;
+  }
+
+  /** @brief Get the UUID_OVERFLOW_WAIT deadline (0 = no limit). */
+  uint32_t getOverflowTimeout() const { return _overflowTimeoutMs; }
+
+  /**
+   * @brief Configure when the v7 generator draws from the RNG.
+   *
+   * UUID_ENTROPY_EVERY_CALL (default) draws 16 bytes on every call and
+   * discards them when the call only increments the counter. With
+   * UUID_ENTROPY_ON_TICK the RNG is only called when the millisecond changes
+   * (or on first use / v4 fallback), so back-to-back IDs within one
+   * millisecond cost a counter bump. The generated IDs are identical in both
+   * modes; ON_TICK merely skips the draws that would be thrown away.
+   * @note v4 generation and the lock-free mode always draw per ID.
+   * @param mode Entropy mode.
+   */
+  void setEntropyMode(UUIDEntropyMode mode) { _entropyMode = mode; }
+
+  /**
+   * @brief Get current entropy mode.
+   * @return Current mode.
+   */
+  UUIDEntropyMode getEntropyMode() const { return _entropyMode; }
+
+  /**
+   * @brief Set how many random bits seed the counter on a new millisecond
+   * (RFC 9562, 6.2 Method 2 guard bits).
+   * The remaining high bits of the 74-bit rand_a/rand_b field start at zero,
+   * guaranteeing at least 2^(74 - bits) IDs per millisecond before overflow.
+   * Sub-millisecond fraction and shard bits are stamped on top.
+   * @param bits Random seed width, 0..74 (default 74: fully random).
+   */
+  void setCounterSeedBits(uint8_t bits) { _seedBits = bits > 74 ? 74 : bits; }
+
+  /** @brief Get the counter seed width in bits. */
+  uint8_t getCounterSeedBits() const { return _seedBits; }
+
+  /**
+   * @brief Use random counter increments ("monotonic random", RFC 9562,
+   * 6.2 Method 2) instead of +1, so consecutive IDs are not guessable.
+   * Each same-millisecond step adds 1 + a random value below 2^bits, taken
+   * from the per-call entropy.
+   * @param bits Random increment width, 0..24 (default 0: increment by one).
+   * @note Under UUID_ENTROPY_ON_TICK no per-call entropy is drawn and the
+   *       counter increments by one.
+   */
+  void setRandomIncrement(uint8_t bits) { _incBits = bits > 24 ? 24 : bits; }
+
+  /** @brief Get the random increment width in bits. */
+  uint8_t getRandomIncrement() const { return _incBits; }
+
   /**
    * @brief Configure persistence to handle reboots/clock resets.
    * @param load_fn Function to read uint64_t timestamp from NVS/EEPROM.
@@ -216,14 +389,75 @@ public:
   void setStorage(uuid_load_fn load_fn, uuid_save_fn save_fn, void *ctx,
                   uint32_t auto_save_interval_ms = 10000);
 
+  /**
+   * @brief Switch persistence to lease mode (0 restores periodic saves).
+   *
+   * Instead of saving about every auto_save_interval_ms, the stored value is
+   * the end of a reserved window: generate() saves "now + lease_ms" only
+   * when the clock comes within margin_ms of the current lease end, and
+   * load() resumes right after the stored lease end. IDs never carry a
+   * timestamp past a stored lease, so the no-collision-after-reboot
+   * guarantee is unchanged while writes drop to one per lease.
+   * @note A reboot skips the unused remainder of the lease (at most
+   *       lease_ms), so size the lease against the clock jump you accept
+   *       as well as the storage's write endurance (e.g. minutes on NOR
+   *       flash, seconds on FRAM). Values stored in periodic mode and lease
+   *       mode are not interchangeable.
+   * @param lease_ms Length of each reserved window in ms.
+   * @param margin_ms Renew this long before the lease ends, covering the time
+   *        the write takes (clamped to lease_ms / 2).
+   */
+  void setStorageLease(uint32_t lease_ms, uint32_t margin_ms = 1000);
+
   /**
    * @brief Load state from storage and apply "Safety Jump".
    * MUST be called in setup() if storage is configured.
-   * Sets internal clock to: loaded_ts + auto_save_interval_ms.
+   * Sets internal clock to: loaded_ts + auto_save_interval_ms (lease mode:
+   * the stored lease end + 1).
    * This prevents collisions for the unsaved time window before a crash.
    */
   void load();
 
+  /**
+   * @brief Select when the persistence save callback runs.
+   *
+   * UUID_PERSIST_INLINE (default) calls save from the generate() call that
+   * crosses the save interval. UUID_PERSIST_DEFERRED only publishes the
+   * high-water mark and flags it dirty; the write is left to flushStorage(),
+   * so slow NVS/flash writes stay off the generate() path and repeated
+   * updates between flushes merge into one write.
+   * @note Call flushStorage() (e.g. from loop() or a low-priority task) more
+   *       often than the save interval. If nothing was written for a full
+   *       interval, generate() falls back to one inline save so load()'s
+   *       safety jump stays valid. load() publishes its jump target, so
+   *       call flushStorage() once after load() in setup() to keep the first
+   *       generate() calls from saving inline.
+   * @param mode Persistence mode.
+   */
+  void setPersistenceMode(UUIDPersistenceMode mode) {
+    _persistence.deferred = (mode == UUID_PERSIST_DEFERRED);
+  }
+
+  /** @brief Get the current persistence mode. */
+  UUIDPersistenceMode getPersistenceMode() const {
+    return _persistence.deferred ? UUID_PERSIST_DEFERRED : UUID_PERSIST_INLINE;
+  }
+
+  /**
+   * @brief Write the pending high-water mark (deferred mode).
+   * Writes only once the mark is half a save interval ahead of the last
+   * write, bounding flash wear to about two writes per interval however
+   * often this is called. The save callback runs on the caller's thread
+   * without holding the lock.
+   * @param force Write any pending mark regardless of the interval (e.g.
+   *        before a planned shutdown).
+   * @return true if a value was written.
+   */
+  bool flushStorage(bool force = false);
+
+  /** @brief Check if a deferred high-water mark is waiting for flushStorage(). */
+  bool isStoragePending() const;
+
   /**
    * @brief Generate a new UUID based on current version setting.
    *
@@ -237,6 +471,103 @@ public:
    */
   UUID7_NODISCARD bool generate();
 
+  /**
+   * @brief Generate a new UUID directly into a caller-provided buffer.
+   * @param out Destination 16-byte array.
+   * @return true if successful (same failure modes as generate()).
+   */
+  UUID7_NODISCARD bool generate(uint8_t out[16]) {
+    return generateBatch(reinterpret_cast<uint8_t (*)[16]>(out), 1) == 1;
+  }
+
+  /** @brief Generate a new UUID into a uuid7::Id (see generate(uint8_t*)). */
+  UUID7_NODISCARD bool generate(uuid7::Id &out) { return generate(out.b); }
+
+  /**
+   * @brief Generate a new UUID and return it by value.
+   * @return The new ID, or uuid7::Id::nil() on failure (never a valid output).
+   */
+  UUID7_NODISCARD uuid7::Id generateId() {
+    uuid7::Id id;
+    if (!generate(id.b))
+      return uuid7::Id::nil();
+    return id;
+  }
+
+  /**
+   * @brief Generate a burst of monotonic UUIDs into a caller-provided buffer.
+   *
+   * Amortizes the per-ID overhead of generate(): the guard and a clock read
+   * are taken once per UUID7_BATCH_LOCK_SPAN IDs (and again while waiting out
+   * a counter overflow), and the entropy for the whole batch is pulled in a
+   * single RNG call. Version, overflow policy and persistence interval are
+   * honoured exactly as in generate().
+   *
+   * Worst case under the guard: UUID7_BATCH_LOCK_SPAN counter steps and
+   * 16-byte stores plus one publish of data(), whatever n is.
+   *
+   * @param out Destination array of n 16-byte slots (also used as RNG scratch).
+   * @param n Number of UUIDs to generate.
+   * @return Number of UUIDs written to out. Less than n only on RNG/clock
+   *         failure or on counter overflow under UUID_OVERFLOW_FAIL_FAST.
+   * @note data() reflects the last UUID of the batch afterwards, except in
+   *       lock-free mode (see setLockFree()) and for UUID_VERSION_4, where
+   *       the batch takes no lock at all.
+   */
+  UUID7_NODISCARD size_t generateBatch(uint8_t (*out)[16], size_t n);
+
+  /**
+   * @brief Reserve n consecutive v7 IDs in one critical section.
+   *
+   * The IDs share one timestamp and the counter values c..c+n-1; the range
+   * materializes them lazily, so workers can number rows locally without
+   * going back to the generator. If the block does not fit the counter space
+   * left in the current millisecond, UUIDOverflowPolicy applies (WAIT retries
+   * in the next millisecond with a fresh seed).
+   *
+   * @param n Number of IDs (1..2^32-1).
+   * @param out Receives the range (emptied on failure).
+   * @return true on success; false on RNG/clock failure, on overflow under
+   *         UUID_OVERFLOW_FAIL_FAST, during a major clock regression (no v7
+   *         block can be issued), for UUID_VERSION_4, and in lock-free mode.
+   * @note data() holds the last ID of the range afterwards. Random counter
+   *       increments (setRandomIncrement()) do not apply within a range.
+   */
+  UUID7_NODISCARD bool reserve(size_t n, UUID7Range &out);
+
+  /**
+   * @brief Enable the lock-free generator mode (v7 only).
+   *
+   * The monotonic state is packed into a single 64-bit word (48-bit timestamp
+   * + 16-bit sequence) and advanced with compare-and-swap, so generate(out)
+   * and generateBatch() never take UUID7Guard and independent instances no
+   * longer serialize on the process-wide lock. The sequence occupies the top
+   * 16 bits of the 74-bit counter field (65536 IDs per millisecond); the
+   * remaining 58 bits stay random. Overflow policy, regression threshold and
+   * persistence interval apply unchanged.
+   *
+   * @note Only available where a native 64-bit CAS exists (UUID7_HAS_ATOMIC64:
+   *       native x86-64/ARM64). Elsewhere the call is ignored.
+   * @note generate(out) and generateBatch() do not refresh the internal buffer
+   *       in this mode; generate() still publishes into it under the guard.
+   * @note Switching modes advances the monotonic state by one millisecond.
+   *       Configure the mode before generating from multiple threads.
+   * @param enable true to enable, false to return to the locked generator.
+   */
+  void setLockFree(bool enable) noexcept;
+
+  /** @brief Check if the lock-free generator mode is active. */
+  bool isLockFree() const noexcept;
+
+  /**
+   * @brief Copy the hot-path counters and latency histogram (see UUID7Stats).
+   * @return false (out cleared) unless built with -DUUID7_ENABLE_STATS.
+   */
+  bool getStats(UUID7Stats &out) const noexcept;
+
+  /** @brief Zero the hot-path counters. */
+  void resetStats() noexcept;
+
   /**
    * @brief Import 16 raw bytes into the UUID object.
    * @param bytes Source 16-byte array.
@@ -255,6 +586,22 @@ public:
   bool toString(char *out, size_t buflen, bool uppercase = false,
                 bool dashes = true) const noexcept;
 
+  /**
+   * @brief Format UUID as 26-character Crockford Base32 (sortable, like ULID).
+   * @param out Destination buffer (must be >= 27 bytes).
+   * @param buflen Length of destination buffer.
+   * @return true if successful, false if buffer is too small.
+   */
+  bool toBase32(char *out, size_t buflen) const noexcept;
+
+  /**
+   * @brief Format UUID as 22-character unpadded Base64url.
+   * @param out Destination buffer (must be >= 23 bytes).
+   * @param buflen Length of destination buffer.
+   * @return true if successful, false if buffer is too small.
+   */
+  bool toBase64Url(char *out, size_t buflen) const noexcept;
+
   /**
    * @brief Access raw 16 bytes of the current UUID.
    * @warning NOT THREAD-SAFE. The internal buffer may change if generate()
@@ -264,6 +611,13 @@ public:
    */
   const uint8_t *data() const noexcept { return _b; }
 
+  /** @brief Consistent copy of the current UUID (safe against concurrent generate()). */
+  uuid7::Id id() const noexcept {
+    uuid7::Id out;
+    _snapshot(out.b);
+    return out;
+  }
+
   /**
    * @brief Parse a UUID string into 16-byte binary format.
    * Supports both 36-character (dashed) and 32-character (undashed) formats.
@@ -273,9 +627,54 @@ public:
    */
   static bool parseFromString(const char *str36, uint8_t out[16]) noexcept;
 
+  /**
+   * @brief Parse a UUID string of known length (36 or 32 chars, no
+   * terminator required) into 16-byte binary format.
+   */
+  static bool parseFromString(const char *str, size_t len,
+                              uint8_t out[16]) noexcept;
+
+  /**
+   * @brief Platform default RNG.
+   * On native builds this is a per-thread ChaCha20 stream keyed from the OS
+   * CSPRNG (lock-free across threads); build with -DUUID7_NATIVE_RNG_OS to
+   * read the OS CSPRNG directly instead.
+   */
   static void default_fill_random(uint8_t *dest, size_t len,
                                   void *ctx) noexcept;
+
+#if defined(PLATFORMIO_NATIVE)
+  /**
+   * @brief Read the OS CSPRNG directly (getrandom() on Linux, arc4random_buf()
+   * on macOS/BSD, std::random_device elsewhere). Usable with setRandomSource().
+   */
+  static void os_fill_random(uint8_t *dest, size_t len, void *ctx) noexcept;
+#endif
+  /**
+   * @brief Platform default clock: a monotonic source (steady_clock,
+   * esp_timer, the RP2040 64-bit timer, or millis() extended to 64 bits)
+   * plus the wall-clock anchor set with setClockAnchor().
+   */
   static uint64_t default_now_ms(void *ctx) noexcept;
+  static uint64_t default_now_us(void *ctx) noexcept;
+
+  /**
+   * @brief Anchor the default clock to wall time, e.g. once after NTP sync.
+   * Later default_now_ms() reads return unix_ms plus the monotonic time
+   * elapsed since this call, so NTP steps no longer move the timestamp.
+   * Native builds anchor to system_clock automatically on the first read;
+   * 0 clears the anchor (native: re-anchor on the next read, MCUs:
+   * boot-relative time).
+   */
+  static void setClockAnchor(uint64_t unix_ms) noexcept;
+
+  /**
+   * @brief Back-off between two generate attempts, shared by the retrying
+   * wrappers. After a counter overflow it sleeps to the next millisecond
+   * tick, phased by us_func (no clock: delay(1) on Arduino, yield()
+   * elsewhere); after any other failure it only yields.
+   */
+  static void retryBackoff(bool overflow, now_us_fn us_func, void *ctx) noexcept;
 
 #if defined(ARDUINO)
   size_t printTo(Print &p) const override {
@@ -326,28 +725,121 @@ public:
 
 private:
   uint8_t _b[16];
+  uint32_t _pubSeq; // Seqlock sequence for _b (odd while a write is in progress)
   UUIDVersion _version;
   UUIDOverflowPolicy _overflowPolicy;
+  UUIDEntropyMode _entropyMode;
   fill_random_fn _rng;
   void *_rng_ctx;
   now_ms_fn _now;
   void *_now_ctx;
+  now_us_fn _now_us;
+  void *_now_us_ctx;
+  bool _subMs;
+  bool _clockPinned; // Time providers owned by UUID7Sharded
+  bool _overflowed;  // Last generate/reserve call stopped on a counter overflow
 
   TimestampState _tsState;
+  UUID7Counter _ctr; // Authoritative rand_a/rand_b state, stored into _b
+  uint8_t _seedBits;
+  uint8_t _incBits;
 
   UUID7PersistenceState _persistence;
 
   uint64_t _entropy_mixer;
 
   uint32_t _regressionThresholdMs;
+  uint32_t _overflowTimeoutMs;
   int16_t _entropyAnalogPin;
   lock_fn_t _lock_cb;
   lock_fn_t _unlock_cb;
+  lock_ctx_fn _lock_ctx_cb;
+  lock_ctx_fn _unlock_ctx_cb;
+  void *_lock_ctx;
+
+  // Fixed prefix in the top bits of rand_b: the node ID (setNodeId()) above
+  // the shard index (UUID7Sharded). _prefix/_prefixBits combine both.
+  uint8_t _nodeBits;
+  uint32_t _nodeId;
+  uint8_t _shardBits;
+  uint16_t _shardId;
+  uint8_t _prefixBits;
+  uint32_t _prefix;
+  template <size_t> friend class UUID7Sharded;
+
+  /** @brief Recompute _prefix/_prefixBits. Caller holds UUID7Guard. */
+  void _updatePrefix() noexcept {
+    _prefixBits = (uint8_t)(_nodeBits + _shardBits);
+    _prefix = (_nodeId << _shardBits) | _shardId;
+  }
+
+#if defined(UUID7_ENABLE_STATS)
+  UUID7Stats _stats;
+#endif
+
+#if defined(UUID7_HAS_ATOMIC64)
+  uint64_t _lfState; // (timestamp << 16) | last issued sequence
+  bool _lockFree;
+
+  size_t _generateBatchLockFree(uint8_t (*out)[16], size_t n) noexcept;
+#endif
+
+  /** @brief v4 core: mix and stamp pre-filled random slots, no guard. */
+  size_t _generateBatchV4(uint8_t (*out)[16], size_t n) noexcept;
+
+  /** @brief generateBatch() / reserve() without the stats wrapper. */
+  size_t _generateBatch(uint8_t (*out)[16], size_t n);
+  bool _reserve(size_t n, UUID7Range &out);
+
+  /** @brief Publish a new current UUID into _b. Caller holds UUID7Guard. */
+  void _publishLocked(const uint8_t id[16]) noexcept;
+
+  /** @brief Copy a consistent snapshot of _b without blocking writers. */
+  void _snapshot(uint8_t out[16]) const noexcept;
+
+  /** @brief Read one byte of _b. */
+  uint8_t _readByte(int i) const noexcept;
+
+  /**
+   * @brief Read the configured clock.
+   * @param frac Receives the sub-millisecond fraction, or -1 if inactive.
+   * @return Milliseconds (0 on clock failure).
+   */
+  uint64_t _readClock(int16_t &frac) noexcept;
+
+  enum StepResult { STEP_OK, STEP_FALLBACK_V4, STEP_OVERFLOW, STEP_NEED_ENTROPY };
 
   /**
-   * @brief Internal helper to increment the random part (74 bits) for
-   * monotonicity.
-   * @return true if increment succeeded, false if overflow occurred.
+   * @brief Advance the monotonic state by one UUID into dst.
+   * Caller must hold UUID7Guard.
+   * @param now_ms Current clock reading (clamped on minor regression).
+   * @param frac Sub-millisecond fraction (0..4095) for rand_a, or -1.
+   * @param rand 16 fresh random bytes (unmixed), or nullptr to defer the
+   *        draw: STEP_NEED_ENTROPY is returned if the step needs fresh bytes.
+   * @param dst Output UUID (may alias rand).
+   * @param overflow_state Sticky flag, set once the counter overflows in the
+   *        current millisecond.
    */
-  bool _incrementRandom() noexcept;
+  StepResult _stepLocked(uint64_t now_ms, int16_t frac, const uint8_t *rand,
+                         uint8_t dst[16], bool &overflow_state) noexcept;
+
+  /**
+   * @brief UUID_OVERFLOW_WAIT back-off after an overflow at now_ms.
+   * @param deadline_ms Set on the first call; 0 before.
+   * @return false once the configured overflow timeout has passed.
+   */
+  bool _overflowWait(uint64_t now_ms, uint64_t &deadline_ms) noexcept;
+
+protected:
+  /**
+   * @brief Sleep until the next millisecond tick. The phase is taken from the
+   * microsecond clock (setPrecisionTimeProvider(), or default_now_us() with
+   * the default clock); without one this only yields.
+   */
+  void _sleepToNextTick() noexcept;
+
+  /** @brief The last generate/reserve failure was a counter overflow. */
+  bool _failedOnOverflow() const noexcept {
+    return __atomic_load_n(&_overflowed, __ATOMIC_RELAXED);
+  }
 };
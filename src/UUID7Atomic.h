@@ -0,0 +1,92 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2026 bkwoka
+// Repository: https://github.com/bkwoka/UUIDv7
+
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+// Lock-free generation requires a native 64-bit compare-and-swap. This holds
+// on native x86-64/ARM64 hosts; 32-bit MCUs (ESP32 Xtensa, RP2040, STM32)
+// only provide 32-bit primitives and keep using UUID7Guard.
+#if !defined(UUID7_NO_LOCK_FREE) && defined(__GCC_ATOMIC_LLONG_LOCK_FREE) &&  \
+    (__GCC_ATOMIC_LLONG_LOCK_FREE == 2)
+#define UUID7_HAS_ATOMIC64
+#endif
+
+#if defined(UUID7_HAS_ATOMIC64)
+namespace uuid7 {
+namespace atomic {
+
+inline uint64_t load(const uint64_t *p) noexcept {
+  return __atomic_load_n(p, __ATOMIC_ACQUIRE);
+}
+
+inline uint64_t loadRelaxed(const uint64_t *p) noexcept {
+  return __atomic_load_n(p, __ATOMIC_RELAXED);
+}
+
+inline void store(uint64_t *p, uint64_t v) noexcept {
+  __atomic_store_n(p, v, __ATOMIC_RELEASE);
+}
+
+/** @brief Weak CAS; on failure `expected` is refreshed with the current value. */
+inline bool cas(uint64_t *p, uint64_t &expected, uint64_t desired) noexcept {
+  return __atomic_compare_exchange_n(p, &expected, desired, true,
+                                     __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE);
+}
+
+} // namespace atomic
+} // namespace uuid7
+#endif
+
+// Readers of the published UUID use a seqlock instead of UUID7Guard where
+// 32-bit atomics are lock-free (ESP32, RP2040, STM32, native). Size-optimized
+// (AVR) builds keep the guard, which only masks interrupts there.
+#if !defined(UUID7_NO_SEQLOCK) && !defined(UUID7_OPTIMIZE_SIZE) &&             \
+    defined(__GCC_ATOMIC_INT_LOCK_FREE) && (__GCC_ATOMIC_INT_LOCK_FREE == 2)
+#define UUID7_HAS_SEQLOCK
+#endif
+
+#if defined(UUID7_HAS_SEQLOCK)
+namespace uuid7 {
+namespace seqlock {
+
+/** @brief Publish n bytes. Writers must be serialized by the caller. */
+inline void write(uint32_t *seq, uint8_t *dst, const uint8_t *src,
+                  size_t n) noexcept {
+  uint32_t s = __atomic_load_n(seq, __ATOMIC_RELAXED);
+  __atomic_store_n(seq, s + 1, __ATOMIC_RELAXED);
+  __atomic_thread_fence(__ATOMIC_RELEASE);
+  for (size_t i = 0; i < n; i++)
+    __atomic_store_n(&dst[i], src[i], __ATOMIC_RELAXED);
+  __atomic_store_n(seq, s + 2, __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief Copy a consistent snapshot of n bytes.
+ * @return false if a writer interfered on every one of `attempts` tries.
+ */
+inline bool read(const uint32_t *seq, const uint8_t *src, uint8_t *dst,
+                 size_t n, int attempts) noexcept {
+  while (attempts-- > 0) {
+    uint32_t s1 = __atomic_load_n(seq, __ATOMIC_ACQUIRE);
+    if (s1 & 1)
+      continue;
+    for (size_t i = 0; i < n; i++)
+      dst[i] = __atomic_load_n(&src[i], __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    if (__atomic_load_n(seq, __ATOMIC_RELAXED) == s1)
+      return true;
+  }
+  return false;
+}
+
+/** @brief Single bytes are never torn and need no sequence check. */
+inline uint8_t loadByte(const uint8_t *p) noexcept {
+  return __atomic_load_n(p, __ATOMIC_RELAXED);
+}
+
+} // namespace seqlock
+} // namespace uuid7
+#endif
@@ -0,0 +1,130 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2026 bkwoka
+// Repository: https://github.com/bkwoka/UUIDv7
+
+#pragma once
+#include "UUID7Codec.h"
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+/**
+ * @brief Bulk inspection of stored IDs held as raw uint8_t[16] arrays.
+ *
+ * Works on the big-endian layout TimestampState::stampBytes() writes; no
+ * generator, no lock and no copy per ID. Timestamp extraction shuffles two
+ * IDs per register on SSSE3/NEON hosts and uses one byte-swapped load per ID
+ * elsewhere (byte loops under UUID7_OPTIMIZE_SIZE).
+ */
+struct UUID7Bulk {
+    /** @brief 48-bit timestamp of one ID (not checked for v7). */
+    static inline uint64_t timestamp(const uint8_t b[16]) noexcept {
+#if !defined(UUID7_OPTIMIZE_SIZE) && defined(__GNUC__) &&                      \
+    defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+        uint64_t w;
+        memcpy(&w, b, 8);
+        return __builtin_bswap64(w) >> 16;
+#else
+        uint64_t ts = 0;
+        for (int i = 0; i < 6; i++)
+            ts = (ts << 8) | b[i];
+        return ts;
+#endif
+    }
+
+    /**
+     * @brief Extract the 48-bit timestamps of n IDs into out[0..n).
+     * Non-v7 IDs yield their first 48 bits; filter with versions() if the
+     * array can hold other versions.
+     */
+    static inline void timestamps(const uint8_t (*in)[16], size_t n, uint64_t *out) noexcept {
+        size_t i = 0;
+#if defined(UUID7_CODEC_SSSE3)
+        // Bytes 5..0 of each ID into the little-endian lanes of one 64-bit slot.
+        const __m128i lo = _mm_setr_epi8(5, 4, 3, 2, 1, 0, -128, -128, -128, -128, -128,
+                                         -128, -128, -128, -128, -128);
+        const __m128i hi = _mm_setr_epi8(-128, -128, -128, -128, -128, -128, -128, -128, 5,
+                                         4, 3, 2, 1, 0, -128, -128);
+        for (; i + 2 <= n; i += 2) {
+            __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in[i]));
+            __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in[i + 1]));
+            __m128i t = _mm_or_si128(_mm_shuffle_epi8(a, lo), _mm_shuffle_epi8(b, hi));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(out + i), t);
+        }
+#elif defined(UUID7_CODEC_NEON)
+        static const uint8_t order[16] = {5, 4, 3, 2, 1, 0, 255, 255,
+                                          21, 20, 19, 18, 17, 16, 255, 255};
+        const uint8x16_t idx = vld1q_u8(order);
+        for (; i + 2 <= n; i += 2) {
+            uint8x16x2_t ab = {{vld1q_u8(in[i]), vld1q_u8(in[i + 1])}};
+            vst1q_u8(reinterpret_cast<uint8_t *>(out + i), vqtbl2q_u8(ab, idx));
+        }
+#endif
+        for (; i < n; i++)
+            out[i] = timestamp(in[i]);
+    }
+
+    /**
+     * @brief Classify n IDs: out[i] is the version nibble if the variant is
+     * RFC 9562 (0b10), 0 otherwise (nil, Microsoft/NCS variants, garbage).
+     */
+    static inline void versions(const uint8_t (*in)[16], size_t n, uint8_t *out) noexcept {
+        for (size_t i = 0; i < n; i++) {
+            uint8_t rfc = (uint8_t)((in[i][8] & 0xC0) == 0x80);
+            out[i] = (uint8_t)((in[i][6] >> 4) & (uint8_t)-rfc);
+        }
+    }
+
+    /** @brief Number of RFC-variant IDs with the given version. */
+    static inline size_t countVersion(const uint8_t (*in)[16], size_t n,
+                                      uint8_t version = 7) noexcept {
+        size_t c = 0;
+        for (size_t i = 0; i < n; i++)
+            c += (size_t)((in[i][6] >> 4) == version && (in[i][8] & 0xC0) == 0x80);
+        return c;
+    }
+
+    /**
+     * @brief Count v7 IDs into time buckets.
+     *
+     * Bucket k covers [start_ms + k*bucket_ms, start_ms + (k+1)*bucket_ms).
+     * Counts are added to counts[] (zero it first for a fresh histogram), so
+     * several arrays can be accumulated into one. Non-v7 IDs and timestamps
+     * outside the bucket range are skipped. Power-of-two widths use a shift
+     * instead of a division.
+     *
+     * @return Number of IDs counted.
+     */
+    static inline size_t histogram(const uint8_t (*in)[16], size_t n, uint64_t start_ms,
+                                   uint64_t bucket_ms, uint32_t *counts,
+                                   size_t buckets) noexcept {
+        if (!in || !counts || bucket_ms == 0 || buckets == 0)
+            return 0;
+        uint64_t span = bucket_ms * (uint64_t)buckets;
+        if (span / buckets != bucket_ms)
+            span = ~0ULL; // Saturate on overflow
+        int shift = -1;
+        if ((bucket_ms & (bucket_ms - 1)) == 0) {
+            shift = 0;
+            while ((1ULL << shift) != bucket_ms)
+                shift++;
+        }
+
+        uint64_t ts[32];
+        size_t counted = 0;
+        for (size_t base = 0; base < n; base += 32) {
+            size_t m = n - base < 32 ? n - base : 32;
+            timestamps(in + base, m, ts);
+            for (size_t j = 0; j < m; j++) {
+                const uint8_t *id = in[base + j];
+                uint64_t d = ts[j] - start_ms; // Wraps for ts < start_ms
+                if ((id[6] >> 4) != 7 || (id[8] & 0xC0) != 0x80 || ts[j] < start_ms ||
+                    d >= span)
+                    continue;
+                counts[shift >= 0 ? (size_t)(d >> shift) : (size_t)(d / bucket_ms)]++;
+                counted++;
+            }
+        }
+        return counted;
+    }
+};
@@ -3,50 +3,223 @@
 // Repository: https://github.com/bkwoka/UUIDv7
 
 #include "UUID7.h"
+#include "UUID7Atomic.h"
 #include "UUID7Guard.h"
 
 #if defined(PLATFORMIO_ESP32) || defined(ARDUINO_ARCH_ESP32)
 #include "esp_timer.h"
+#elif defined(ARDUINO_ARCH_RP2040) && defined(PICO_SDK_VERSION_MAJOR)
+#include "hardware/timer.h"
 #elif defined(PLATFORMIO_NATIVE)
 #include <chrono>
 #endif
 
-uint64_t UUID7::default_now_ms(void *ctx) noexcept {
-  (void)ctx;
+#if defined(PLATFORMIO_ESP32) || defined(ARDUINO_ARCH_ESP32) ||                \
+    (defined(ARDUINO_ARCH_RP2040) && defined(PICO_SDK_VERSION_MAJOR)) ||       \
+    defined(PLATFORMIO_NATIVE) || defined(ARDUINO)
+#define UUID7_HAS_DEFAULT_CLOCK
+#endif
+
+namespace {
+
+// Wall-clock time of monotonic zero, in ms. Written by setClockAnchor() (and
+// once automatically on native); 0 means no anchor.
+#if defined(UUID7_HAS_SEQLOCK)
+uint64_t s_anchor_ms = 0;
+uint32_t s_anchor_seq = 0;
+#else
+// Without 32-bit atomics (AVR) the anchor is double-buffered: the writer
+// fills the idle slot under UUID7Guard, then flips the single-byte
+// generation, which cannot tear. Readers take no lock and retry if the
+// generation moved under them.
+uint64_t s_anchor_slot[2] = {0, 0};
+volatile uint8_t s_anchor_gen = 0;
+#endif
+
+// Caller holds UUID7Guard.
+uint64_t anchor_locked() noexcept {
+#if defined(UUID7_HAS_SEQLOCK)
+  return s_anchor_ms;
+#else
+  return s_anchor_slot[s_anchor_gen & 1];
+#endif
+}
+
+void write_anchor_locked(uint64_t v) noexcept {
+#if defined(UUID7_HAS_SEQLOCK)
+  uuid7::seqlock::write(&s_anchor_seq, (uint8_t *)&s_anchor_ms,
+                        (const uint8_t *)&v, sizeof(v));
+#else
+  uint8_t gen = s_anchor_gen;
+  s_anchor_slot[(gen + 1) & 1] = v;
+  __atomic_signal_fence(__ATOMIC_SEQ_CST); // Slot before generation
+  s_anchor_gen = (uint8_t)(gen + 1);
+#endif
+}
+
+void write_anchor(uint64_t v) noexcept {
+  UUID7Guard lock(nullptr, nullptr);
+  write_anchor_locked(v);
+}
+
+#if defined(PLATFORMIO_NATIVE)
+// Install v unless an anchor is already set; returns the one in effect.
+uint64_t install_anchor(uint64_t v) noexcept {
+  UUID7Guard lock(nullptr, nullptr);
+  uint64_t cur = anchor_locked();
+  if (cur != 0)
+    return cur;
+  write_anchor_locked(v);
+  return v;
+}
+#endif
+
+uint64_t read_anchor() noexcept {
+  uint64_t v;
+#if defined(UUID7_HAS_SEQLOCK)
+  // The anchor changes at most a few times per boot; readers never block.
+  if (uuid7::seqlock::read(&s_anchor_seq, (const uint8_t *)&s_anchor_ms,
+                           (uint8_t *)&v, sizeof(v), 4))
+    return v;
+  UUID7Guard lock(nullptr, nullptr);
+  v = s_anchor_ms;
+#else
+  uint8_t gen;
+  do {
+    gen = s_anchor_gen;
+    __atomic_signal_fence(__ATOMIC_SEQ_CST);
+    v = s_anchor_slot[gen & 1];
+    __atomic_signal_fence(__ATOMIC_SEQ_CST);
+  } while (s_anchor_gen != gen);
+#endif
+  return v;
+}
+
+#if defined(UUID7_HAS_DEFAULT_CLOCK)
+#if !defined(PLATFORMIO_NATIVE) && !defined(PLATFORMIO_ESP32) &&               \
+    !defined(ARDUINO_ARCH_ESP32) &&                                            \
+    !(defined(ARDUINO_ARCH_RP2040) && defined(PICO_SDK_VERSION_MAJOR))
+// Fallback for AVR, ESP8266, STM32, and RP2040 (Mbed core).
+// Standard millis() returns a uint32_t which overflows after
+// approximately 49.7 days. It is extended to 64 bits with a wrap count kept
+// next to the top byte of the last reading: (wraps << 8) | (ms >> 24). That
+// word only changes every 2^24 ms (~4.7 hours), so reads are lock-free and
+// only the rare update takes UUID7Guard. A wrap is seen as the top byte
+// going down, which holds for gaps of up to 2^32 - 2^24 ms (~49.5 days)
+// between reads.
+volatile uint32_t s_ms_state = 0;
+
+uint64_t millis64() noexcept {
+  while (true) {
+    uint32_t st = s_ms_state;
+    uint32_t now = millis();
+    // A word torn by an interrupting update reads differently the second time.
+    if (s_ms_state != st)
+      continue;
+    uint32_t wraps = st >> 8;
+    uint8_t top = (uint8_t)(now >> 24);
+    if (top < (uint8_t)st)
+      wraps++;
+    uint32_t next = (wraps << 8) | top;
+    if (next != st) {
+      UUID7Guard lock(nullptr, nullptr);
+      // Another reader may have moved the word on already; re-read if so.
+      if (s_ms_state != st)
+        continue;
+      s_ms_state = next;
+    }
+    return ((uint64_t)wraps << 32) | now;
+  }
+}
+#endif
+
+// Monotonic time since an arbitrary origin (boot on MCUs).
+uint64_t monotonic_us() noexcept {
 #if defined(PLATFORMIO_NATIVE)
   using namespace std::chrono;
-  return (uint64_t)duration_cast<milliseconds>(
-             system_clock::now().time_since_epoch())
+  return (uint64_t)duration_cast<microseconds>(
+             steady_clock::now().time_since_epoch())
       .count();
 #elif defined(PLATFORMIO_ESP32) || defined(ARDUINO_ARCH_ESP32)
   // ESP32 provides a native 64-bit microsecond timer. Overflow occurs in
   // ~292,000 years.
-  return (uint64_t)(esp_timer_get_time() / 1000ULL);
-#elif defined(ARDUINO)
-  // Fallback for AVR, ESP8266, STM32, and RP2040.
-  // Standard millis() returns a uint32_t which overflows after
-  // approximately 49.7 days. A static accumulator is used to extend the value
-  // to 64 bits.
-  static uint32_t s_prev_ms = 0;
-  static uint64_t s_epoch_offset = 0;
-
-  uint32_t now = millis();
-  uint64_t result;
-  {
-    // Protect static accumulator from concurrent access on multi-core (RP2040)
-    // or preemptive RTOS environments (STM32 FreeRTOS).
-    UUID7Guard lock(nullptr, nullptr);
-    if (now < s_prev_ms) {
-      // Increment epoch offset by 2^32 milliseconds
-      s_epoch_offset += 0x100000000ULL;
-    }
-    s_prev_ms = now;
-    result = s_epoch_offset + now;
+  return (uint64_t)esp_timer_get_time();
+#elif defined(ARDUINO_ARCH_RP2040) && defined(PICO_SDK_VERSION_MAJOR)
+  // 64-bit hardware timer, latched on read; no lock needed across cores.
+  return time_us_64();
+#else
+  // micros() wraps after ~71.6 minutes, too often to count wraps between
+  // reads. Take its upper bits from millis64() instead: of the values
+  // k * 2^32 + micros(), pick the one nearest millis64() * 1000. Both run
+  // off the same timer, so they agree to far better than half a wrap.
+  uint64_t approx = millis64() * 1000ULL;
+  uint32_t low = micros();
+  uint64_t us = (approx & ~0xFFFFFFFFULL) | low;
+  if (us > approx + 0x80000000ULL && us >= 0x100000000ULL)
+    us -= 0x100000000ULL;
+  else if (us + 0x80000000ULL < approx)
+    us += 0x100000000ULL;
+  return us;
+#endif
+}
+
+uint64_t monotonic_ms() noexcept {
+#if defined(PLATFORMIO_NATIVE)
+  using namespace std::chrono;
+  return (uint64_t)duration_cast<milliseconds>(
+             steady_clock::now().time_since_epoch())
+      .count();
+#elif defined(PLATFORMIO_ESP32) || defined(ARDUINO_ARCH_ESP32) ||              \
+    (defined(ARDUINO_ARCH_RP2040) && defined(PICO_SDK_VERSION_MAJOR))
+  return monotonic_us() / 1000ULL;
+#else
+  return millis64();
+#endif
+}
+
+uint64_t current_anchor() noexcept {
+  uint64_t anchor = read_anchor();
+#if defined(PLATFORMIO_NATIVE)
+  if (anchor == 0) {
+    // Anchor steady_clock to system_clock once. Later reads are immune to
+    // NTP steps; setClockAnchor(0) re-anchors after a deliberate change.
+    using namespace std::chrono;
+    uint64_t wall = (uint64_t)duration_cast<milliseconds>(
+                        system_clock::now().time_since_epoch())
+                        .count();
+    // Racing first reads each compute a candidate; only one is installed.
+    anchor = install_anchor(wall - monotonic_ms());
   }
+#endif
+  return anchor;
+}
+#endif
 
-  return result;
+} // namespace
+
+void UUID7::setClockAnchor(uint64_t unix_ms) noexcept {
+#if defined(UUID7_HAS_DEFAULT_CLOCK)
+  write_anchor(unix_ms ? unix_ms - monotonic_ms() : 0);
+#else
+  (void)unix_ms;
+#endif
+}
+
+uint64_t UUID7::default_now_ms(void *ctx) noexcept {
+  (void)ctx;
+#if defined(UUID7_HAS_DEFAULT_CLOCK)
+  return current_anchor() + monotonic_ms();
 #else
   #warning "UUID7: No clock source detected for this platform. Inject a time provider via setTimeProvider() or generate() will always return false."
   return 0;
 #endif
 }
+
+uint64_t UUID7::default_now_us(void *ctx) noexcept {
+  (void)ctx;
+#if defined(UUID7_HAS_DEFAULT_CLOCK)
+  return current_anchor() * 1000ULL + monotonic_us();
+#else
+  return 0;
+#endif
+}
@@ -8,6 +8,27 @@
 #include <stdint.h>
 #include <string.h>
 
+// Vectorized hex paths for hosts that provide them at compile time
+// (-mssse3 / -march=native on x86-64, always on AArch64). Size-optimized
+// builds keep the original nibble loops; everything else uses lookup tables.
+#if !defined(UUID7_OPTIMIZE_SIZE) && !defined(UUID7_NO_SIMD)
+#if defined(__SSSE3__)
+#include <tmmintrin.h>
+#define UUID7_CODEC_SSSE3
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#define UUID7_CODEC_NEON
+#endif
+#endif
+
+// Relaxed constexpr (loops, local writes) is C++14; gnu++11 builds get the
+// same functions as ordinary inline code.
+#if defined(__cpp_constexpr) && __cpp_constexpr >= 201304L
+#define UUID7_CONSTEXPR14 constexpr
+#else
+#define UUID7_CONSTEXPR14 inline
+#endif
+
 struct UUID7Codec {
     static inline bool encode(const uint8_t bytes[16], char *out, size_t buflen,
                               bool uppercase = false, bool dashes = true) noexcept {
@@ -16,43 +37,259 @@ struct UUID7Codec {
             return false;
         }
 
-        static const char hexLower[] = "0123456789abcdef";
-        static const char hexUpper[] = "0123456789ABCDEF";
-        const char *hex = uppercase ? hexUpper : hexLower;
+        if (dashes) {
+            hexDashed(bytes, out, uppercase);
+            out[36] = '\0';
+        } else {
+            hex32(bytes, out, uppercase);
+            out[32] = '\0';
+        }
+        return true;
+    }
 
-        const uint8_t *p = bytes;
-        char *s = out;
+    /** Flags for encodeMany() / decodeMany(). */
+    enum Flags {
+        UPPERCASE = 1, // Emit 'A'-'F' (decoding accepts both cases regardless)
+        NO_DASHES = 2, // 32-character form instead of 36
+        TERMINATE = 4  // encodeMany(): NUL-terminate every item
+    };
 
-        for (int i = 0; i < 16; i++) {
-            if (dashes && (i == 4 || i == 6 || i == 8 || i == 10)) {
-                *s++ = '-';
+    /**
+     * @brief Format n UUIDs into a strided character buffer.
+     * Item i is written at out + i * stride; the bytes between items are left
+     * untouched, so separators (',', '\n', quotes) can be pre-filled.
+     * @param stride Distance between items; at least 36 (32 with NO_DASHES),
+     *        plus one with TERMINATE.
+     * @return n, or 0 if the arguments are invalid.
+     */
+    static inline size_t encodeMany(const uint8_t (*in)[16], size_t n, char *out,
+                                    size_t stride, unsigned flags = 0) noexcept {
+        bool uppercase = (flags & UPPERCASE) != 0;
+        bool dashes = (flags & NO_DASHES) == 0;
+        bool terminate = (flags & TERMINATE) != 0;
+        size_t width = dashes ? 36 : 32;
+        if (!in || !out || stride < width + (terminate ? 1 : 0)) {
+            return 0;
+        }
+
+        // Format branch hoisted out of the per-item loops.
+        if (dashes) {
+            for (size_t i = 0; i < n; i++) {
+                hexDashed(in[i], out + i * stride, uppercase);
+            }
+        } else {
+            for (size_t i = 0; i < n; i++) {
+                hex32(in[i], out + i * stride, uppercase);
+            }
+        }
+        if (terminate) {
+            for (size_t i = 0; i < n; i++) {
+                out[i * stride + width] = '\0';
             }
-            *s++ = hex[(*p >> 4) & 0x0F];
-            *s++ = hex[*p++ & 0x0F];
         }
+        return n;
+    }
 
-        *s = '\0';
-        return true;
+    /**
+     * @brief Parse n strided UUID strings (36 chars, or 32 with NO_DASHES).
+     * Invalid items are zeroed in out and cleared in the validity mask.
+     * @param valid Optional bitmask of (n + 7) / 8 bytes; bit (i % 8) of
+     *        byte i / 8 is set if item i parsed.
+     * @return Number of valid items.
+     */
+    static inline size_t decodeMany(const char *in, size_t n, size_t stride,
+                                    uint8_t (*out)[16], uint8_t *valid = nullptr,
+                                    unsigned flags = 0) noexcept {
+        size_t width = (flags & NO_DASHES) ? 32 : 36;
+        if (valid) {
+            memset(valid, 0, (n + 7) / 8);
+        }
+        if (!in || !out || stride < width) {
+            return 0;
+        }
+
+        size_t ok = 0;
+        for (size_t i = 0; i < n; i++) {
+            if (decode(in + i * stride, width, out[i])) {
+                ok++;
+                if (valid) {
+                    valid[i / 8] |= (uint8_t)(1u << (i % 8));
+                }
+            } else {
+                memset(out[i], 0, 16);
+            }
+        }
+        return ok;
     }
 
+    /** @brief Write the 36-character dashed form (no terminator). */
+    static inline void hexDashed(const uint8_t bytes[16], char out[36], bool uppercase) noexcept {
+        // 8-4-4-4-12 layout
+#if defined(UUID7_CODEC_SSSE3)
+        __m128i h0, h1;
+        hexVectors(bytes, uppercase, h0, h1);
+        // Spread the 32 hex digits over the dashed layout with two shuffles
+        // per 16-byte output lane (0x80 lanes become zero, then take the dash).
+        const __m128i dash = _mm_set1_epi8('-');
+        __m128i m0 = _mm_setr_epi8(0, 1, 2, 3, 4, 5, 6, 7, -128, 8, 9, 10, 11, -128, 12, 13);
+        __m128i d0 = _mm_setr_epi8(0, 0, 0, 0, 0, 0, 0, 0, -1, 0, 0, 0, 0, -1, 0, 0);
+        __m128i m1a = _mm_setr_epi8(14, 15, -128, -128, -128, -128, -128, -128,
+                                    -128, -128, -128, -128, -128, -128, -128, -128);
+        __m128i m1b = _mm_setr_epi8(-128, -128, -128, 0, 1, 2, 3, -128, 4, 5, 6, 7, 8, 9, 10, 11);
+        __m128i d1 = _mm_setr_epi8(0, 0, -1, 0, 0, 0, 0, -1, 0, 0, 0, 0, 0, 0, 0, 0);
+        __m128i o0 = _mm_or_si128(_mm_shuffle_epi8(h0, m0), _mm_and_si128(d0, dash));
+        __m128i o1 = _mm_or_si128(_mm_or_si128(_mm_shuffle_epi8(h0, m1a), _mm_shuffle_epi8(h1, m1b)),
+                                  _mm_and_si128(d1, dash));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out), o0);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out + 16), o1);
+        uint32_t tail = (uint32_t)_mm_cvtsi128_si32(_mm_srli_si128(h1, 12));
+        memcpy(out + 32, &tail, 4);
+#else
+        char hex[32];
+        hex32(bytes, hex, uppercase);
+        memcpy(out, hex, 8);
+        out[8] = '-';
+        memcpy(out + 9, hex + 8, 4);
+        out[13] = '-';
+        memcpy(out + 14, hex + 12, 4);
+        out[18] = '-';
+        memcpy(out + 19, hex + 16, 4);
+        out[23] = '-';
+        memcpy(out + 24, hex + 20, 12);
+#endif
+    }
+
+    /**
+     * @brief Decode a NUL-terminated 36-char (dashed) or 32-char UUID string.
+     */
     static inline bool decode(const char *str, uint8_t out[16]) noexcept {
-        if (!str || !out) {
+        if (!str) {
             return false;
         }
+        // Bounded length scan: anything longer than 36 is rejected anyway.
+        size_t len = 0;
+        while (len < 37 && str[len]) {
+            len++;
+        }
+        return decode(str, len, out);
+    }
 
-        size_t len = strlen(str);
-        bool dashed;
+    /**
+     * @brief Decode a UUID string of known length (36 dashed or 32 plain).
+     * The input does not need to be NUL-terminated.
+     */
+    static inline bool decode(const char *str, size_t len, uint8_t out[16]) noexcept {
+        if (!str || !out) {
+            return false;
+        }
 
-        if (len == 36) {
-            dashed = true;
-        } else if (len == 32) {
-            dashed = false;
-        } else {
+        if (len == 32) {
+            return unhex32(str, out);
+        }
+        if (len != 36 || str[8] != '-' || str[13] != '-' || str[18] != '-' ||
+            str[23] != '-') {
             return false;
         }
 
-        const char *p = str;
+#if defined(UUID7_CODEC_SSSE3)
+        // Gather the 32 digits straight from three overlapping loads.
+        __m128i v0 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(str));
+        __m128i v1 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(str + 16));
+        __m128i v2 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(str + 20));
+        __m128i c0 = _mm_or_si128(
+            _mm_shuffle_epi8(v0, _mm_setr_epi8(0, 1, 2, 3, 4, 5, 6, 7, 9, 10, 11, 12, 14, 15,
+                                               -128, -128)),
+            _mm_shuffle_epi8(v1, _mm_setr_epi8(-128, -128, -128, -128, -128, -128, -128, -128,
+                                               -128, -128, -128, -128, -128, -128, 0, 1)));
+        __m128i c1 = _mm_or_si128(
+            _mm_shuffle_epi8(v1, _mm_setr_epi8(3, -128, -128, -128, -128, -128, -128, -128,
+                                               -128, -128, -128, -128, -128, -128, -128, -128)),
+            _mm_shuffle_epi8(v2, _mm_setr_epi8(-128, 0, 1, 2, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13,
+                                               14, 15)));
+        return unhexVectors(c0, c1, out);
+#else
+        char hex[32];
+        memcpy(hex, str, 8);
+        memcpy(hex + 8, str + 9, 4);
+        memcpy(hex + 12, str + 14, 4);
+        memcpy(hex + 16, str + 19, 4);
+        memcpy(hex + 20, str + 24, 12);
+        return unhex32(hex, out);
+#endif
+    }
+
+    /** @brief Write 32 hex characters for 16 bytes (no terminator). */
+    static inline void hex32(const uint8_t bytes[16], char hex[32], bool uppercase) noexcept {
+#if defined(UUID7_CODEC_SSSE3)
+        __m128i h0, h1;
+        hexVectors(bytes, uppercase, h0, h1);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(hex), h0);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(hex + 16), h1);
+#elif defined(UUID7_CODEC_NEON)
+        const uint8x16_t digits = vld1q_u8(reinterpret_cast<const uint8_t *>(
+            uppercase ? "0123456789ABCDEF" : "0123456789abcdef"));
+        uint8x16_t in = vld1q_u8(bytes);
+        uint8x16x2_t chars;
+        chars.val[0] = vqtbl1q_u8(digits, vshrq_n_u8(in, 4));
+        chars.val[1] = vqtbl1q_u8(digits, vandq_u8(in, vdupq_n_u8(0x0F)));
+        vst2q_u8(reinterpret_cast<uint8_t *>(hex), chars);
+#elif defined(UUID7_OPTIMIZE_SIZE)
+        static const char hexLower[] = "0123456789abcdef";
+        static const char hexUpper[] = "0123456789ABCDEF";
+        const char *digits = uppercase ? hexUpper : hexLower;
+        for (int i = 0; i < 16; i++) {
+            *hex++ = digits[(bytes[i] >> 4) & 0x0F];
+            *hex++ = digits[bytes[i] & 0x0F];
+        }
+#else
+        // Byte -> two-character table. Uppercase clears bit 5 of letters only
+        // (bit 6 is set for 'a'-'f' and clear for '0'-'9').
+        static const char pairs[] =
+        "000102030405060708090a0b0c0d0e0f"
+        "101112131415161718191a1b1c1d1e1f"
+        "202122232425262728292a2b2c2d2e2f"
+        "303132333435363738393a3b3c3d3e3f"
+        "404142434445464748494a4b4c4d4e4f"
+        "505152535455565758595a5b5c5d5e5f"
+        "606162636465666768696a6b6c6d6e6f"
+        "707172737475767778797a7b7c7d7e7f"
+        "808182838485868788898a8b8c8d8e8f"
+        "909192939495969798999a9b9c9d9e9f"
+        "a0a1a2a3a4a5a6a7a8a9aaabacadaeaf"
+        "b0b1b2b3b4b5b6b7b8b9babbbcbdbebf"
+        "c0c1c2c3c4c5c6c7c8c9cacbcccdcecf"
+        "d0d1d2d3d4d5d6d7d8d9dadbdcdddedf"
+        "e0e1e2e3e4e5e6e7e8e9eaebecedeeef"
+        "f0f1f2f3f4f5f6f7f8f9fafbfcfdfeff";
+        for (int i = 0; i < 16; i++) {
+            char a = pairs[bytes[i] * 2];
+            char b = pairs[bytes[i] * 2 + 1];
+            if (uppercase) {
+                a = (char)(a & ~((a >> 1) & 0x20));
+                b = (char)(b & ~((b >> 1) & 0x20));
+            }
+            hex[i * 2] = a;
+            hex[i * 2 + 1] = b;
+        }
+#endif
+    }
 
+    /** @brief Validate and decode 32 hex characters into 16 bytes. */
+    static inline bool unhex32(const char hex[32], uint8_t out[16]) noexcept {
+#if defined(UUID7_CODEC_SSSE3)
+        return unhexVectors(_mm_loadu_si128(reinterpret_cast<const __m128i *>(hex)),
+                            _mm_loadu_si128(reinterpret_cast<const __m128i *>(hex + 16)), out);
+#elif defined(UUID7_CODEC_NEON)
+        uint8x16x2_t chars = vld2q_u8(reinterpret_cast<const uint8_t *>(hex));
+        uint8x16_t ok = vdupq_n_u8(0xFF);
+        uint8x16_t hi = nibbles(chars.val[0], ok);
+        uint8x16_t lo = nibbles(chars.val[1], ok);
+        if (vminvq_u8(ok) != 0xFF) {
+            return false;
+        }
+        vst1q_u8(out, vorrq_u8(vshlq_n_u8(hi, 4), lo));
+        return true;
+#elif defined(UUID7_OPTIMIZE_SIZE)
         auto hexval =[](char c) -> int {
             if (c >= '0' && c <= '9') return c - '0';
             if (c >= 'a' && c <= 'f') return 10 + c - 'a';
@@ -61,19 +298,355 @@ struct UUID7Codec {
         };
 
         for (int i = 0; i < 16; i++) {
-            if (dashed && (i == 4 || i == 6 || i == 8 || i == 10)) {
-                if (*p != '-') return false;
-                p++;
-            }
-
-            int hi = hexval(*p++);
-            int lo = hexval(*p++);
+            int hi = hexval(*hex++);
+            int lo = hexval(*hex++);
 
             if (hi < 0 || lo < 0) return false;
 
             out[i] = (uint8_t)((hi << 4) | lo);
         }
+        return true;
+#else
+        static const uint8_t values[256] = {
+            0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+            0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+            0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+            0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+            0xFF, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+            0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+            0xFF, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+            0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+            0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+            0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+            0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+            0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+            0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+            0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+            0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+            0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+        };
+        // Invalid characters map to 0xFF; OR-accumulate and check once.
+        uint8_t acc = 0;
+        for (int i = 0; i < 16; i++) {
+            uint8_t hi = values[(uint8_t)hex[i * 2]];
+            uint8_t lo = values[(uint8_t)hex[i * 2 + 1]];
+            acc |= hi | lo;
+            out[i] = (uint8_t)((hi << 4) | lo);
+        }
+        return (acc & 0xF0) == 0;
+#endif
+    }
+
+    /**
+     * @brief Crockford Base32 (26 chars, uppercase). The 128-bit value is
+     * left-padded to 130 bits, so string order matches byte order.
+     * @param buflen Must be >= 27.
+     */
+    static inline bool encodeBase32(const uint8_t bytes[16], char *out, size_t buflen) noexcept {
+        static const char alphabet[] = "0123456789ABCDEFGHJKMNPQRSTVWXYZ";
+        if (!out || buflen < 27) {
+            return false;
+        }
+        uint64_t hi, lo;
+        load128(bytes, hi, lo);
+        for (int i = 25; i >= 0; i--) {
+            out[i] = alphabet[lo & 31];
+            lo = (lo >> 5) | (hi << 59);
+            hi >>= 5;
+        }
+        out[26] = '\0';
+        return true;
+    }
+
+    /**
+     * @brief Decode 26 Crockford Base32 characters. Case-insensitive; 'O' is
+     * read as 0 and 'I'/'L' as 1. Values above 128 bits are rejected.
+     */
+    static inline bool decodeBase32(const char *str, size_t len, uint8_t out[16]) noexcept {
+        // 'A'..'Z' -> value, 0xFF for U
+        static const uint8_t letters[26] = {10, 11, 12, 13, 14, 15, 16, 17, 1, 18, 19, 1, 20,
+                                            21, 0, 22, 23, 24, 25, 26, 0xFF, 27, 28, 29, 30, 31};
+        if (!str || !out || len != 26) {
+            return false;
+        }
+        uint64_t hi = 0, lo = 0;
+        for (size_t i = 0; i < 26; i++) {
+            char c = str[i];
+            uint8_t v;
+            if (c >= '0' && c <= '9') {
+                v = (uint8_t)(c - '0');
+            } else if (c >= 'a' && c <= 'z') {
+                v = letters[c - 'a'];
+            } else if (c >= 'A' && c <= 'Z') {
+                v = letters[c - 'A'];
+            } else {
+                return false;
+            }
+            if (v > 31 || (i == 0 && v > 7)) {
+                return false;
+            }
+            hi = (hi << 5) | (lo >> 59);
+            lo = (lo << 5) | v;
+        }
+        store128(hi, lo, out);
+        return true;
+    }
+
+    /**
+     * @brief Base64url without padding (22 chars, RFC 4648 section 5).
+     * @param buflen Must be >= 23.
+     */
+    static inline bool encodeBase64Url(const uint8_t bytes[16], char *out, size_t buflen) noexcept {
+        static const char alphabet[] =
+            "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+        if (!out || buflen < 23) {
+            return false;
+        }
+        char *s = out;
+        for (int i = 0; i < 15; i += 3) {
+            uint32_t v = ((uint32_t)bytes[i] << 16) | ((uint32_t)bytes[i + 1] << 8) | bytes[i + 2];
+            *s++ = alphabet[(v >> 18) & 63];
+            *s++ = alphabet[(v >> 12) & 63];
+            *s++ = alphabet[(v >> 6) & 63];
+            *s++ = alphabet[v & 63];
+        }
+        *s++ = alphabet[bytes[15] >> 2];
+        *s++ = alphabet[(bytes[15] & 3) << 4];
+        *s = '\0';
+        return true;
+    }
+
+    /**
+     * @brief Decode 22 Base64url characters. Non-canonical input (non-zero
+     * trailing bits) is rejected.
+     */
+    static inline bool decodeBase64Url(const char *str, size_t len, uint8_t out[16]) noexcept {
+        if (!str || !out || len != 22) {
+            return false;
+        }
+        uint8_t v[22];
+        for (size_t i = 0; i < 22; i++) {
+            char c = str[i];
+            if (c >= 'A' && c <= 'Z') v[i] = (uint8_t)(c - 'A');
+            else if (c >= 'a' && c <= 'z') v[i] = (uint8_t)(c - 'a' + 26);
+            else if (c >= '0' && c <= '9') v[i] = (uint8_t)(c - '0' + 52);
+            else if (c == '-') v[i] = 62;
+            else if (c == '_') v[i] = 63;
+            else return false;
+        }
+        if (v[21] & 0x0F) {
+            return false;
+        }
+        for (int i = 0, j = 0; i < 15; i += 3, j += 4) {
+            uint32_t w = ((uint32_t)v[j] << 18) | ((uint32_t)v[j + 1] << 12) |
+                         ((uint32_t)v[j + 2] << 6) | v[j + 3];
+            out[i] = (uint8_t)(w >> 16);
+            out[i + 1] = (uint8_t)(w >> 8);
+            out[i + 2] = (uint8_t)w;
+        }
+        out[15] = (uint8_t)((v[20] << 2) | (v[21] >> 4));
+        return true;
+    }
+
+    /**
+     * @brief Compact binary form of a sorted run: each UUID is stored as the
+     * LEB128 varint of its 128-bit difference to the previous one (the first
+     * to zero). Same-millisecond v7 neighbours typically take 1-2 bytes.
+     * @param cap Capacity of out in bytes (19 * n always suffices).
+     * @return Bytes written, or 0 if the run is not sorted ascending or does
+     *         not fit.
+     */
+    static inline size_t encodeDeltaRun(const uint8_t (*in)[16], size_t n, uint8_t *out,
+                                        size_t cap) noexcept {
+        if (!in || !out) {
+            return 0;
+        }
+        uint64_t prev_hi = 0, prev_lo = 0;
+        size_t pos = 0;
+        for (size_t i = 0; i < n; i++) {
+            uint64_t hi, lo;
+            load128(in[i], hi, lo);
+            if (hi < prev_hi || (hi == prev_hi && lo < prev_lo)) {
+                return 0;
+            }
+            uint64_t d_lo = lo - prev_lo;
+            uint64_t d_hi = hi - prev_hi - (lo < prev_lo ? 1 : 0);
+            prev_hi = hi;
+            prev_lo = lo;
+            do {
+                if (pos == cap) {
+                    return 0;
+                }
+                uint8_t b = (uint8_t)(d_lo & 0x7F);
+                d_lo = (d_lo >> 7) | (d_hi << 57);
+                d_hi >>= 7;
+                out[pos++] = (d_lo | d_hi) ? (uint8_t)(b | 0x80) : b;
+            } while (out[pos - 1] & 0x80);
+        }
+        return pos;
+    }
+
+    /**
+     * @brief Decode a run produced by encodeDeltaRun().
+     * @return Number of UUIDs decoded, or 0 on a truncated / oversized varint
+     *         or if the run holds more than max_n entries.
+     */
+    static inline size_t decodeDeltaRun(const uint8_t *in, size_t len, uint8_t (*out)[16],
+                                        size_t max_n) noexcept {
+        if (!in || !out) {
+            return 0;
+        }
+        uint64_t hi = 0, lo = 0;
+        size_t n = 0, pos = 0;
+        while (pos < len) {
+            if (n == max_n) {
+                return 0;
+            }
+            uint64_t d_hi = 0, d_lo = 0;
+            unsigned shift = 0;
+            uint8_t b;
+            do {
+                if (pos == len || shift > 126) {
+                    return 0;
+                }
+                b = in[pos++];
+                uint64_t v = b & 0x7F;
+                if (shift == 126 && v > 3) {
+                    return 0; // Beyond 128 bits
+                }
+                if (shift < 64) {
+                    d_lo |= v << shift;
+                    if (shift > 57) d_hi |= v >> (64 - shift);
+                } else {
+                    d_hi |= v << (shift - 64);
+                }
+                shift += 7;
+            } while (b & 0x80);
+            lo += d_lo;
+            hi += d_hi + (lo < d_lo ? 1 : 0);
+            store128(hi, lo, out[n++]);
+        }
+        return n;
+    }
+
+    // --- Compile-time path: single-expression constexpr, valid since C++11 ---
+
+    /** @brief Value of a hex digit (either case), or -1. */
+    static constexpr int hexValue(char c) noexcept {
+        return (c >= '0' && c <= '9')   ? c - '0'
+               : (c >= 'a' && c <= 'f') ? c - 'a' + 10
+               : (c >= 'A' && c <= 'F') ? c - 'A' + 10
+                                        : -1;
+    }
+
+    /** @brief Hex digit for a nibble. */
+    static constexpr char hexDigit(unsigned v, bool uppercase) noexcept {
+        return (char)(v < 10 ? '0' + v : (uppercase ? 'A' : 'a') + v - 10);
+    }
+
+    /**
+     * @brief Check a 36-char dashed or 32-char UUID string of known length
+     * (no terminator required). Constexpr counterpart of decode()'s checks.
+     */
+    static constexpr bool isValid(const char *str, size_t len) noexcept {
+        return str != nullptr &&
+               (len == 32 ? digitsValid(str, 0, false)
+                          : len == 36 && str[8] == '-' && str[13] == '-' &&
+                                str[18] == '-' && str[23] == '-' &&
+                                digitsValid(str, 0, true));
+    }
+
+    /**
+     * @brief Decode one big-endian 64-bit half (0: bytes 0..7, 1: bytes
+     * 8..15) of a string that passed isValid().
+     */
+    static constexpr uint64_t decodeHalf(const char *str, size_t len, int half) noexcept {
+        return hexWord(str, len == 36, half ? 16 : 0, 16, 0);
+    }
+
+private:
+    // Offset of hex digit k (0..31) in the dashed or undashed form.
+    static constexpr size_t digitPos(size_t k, bool dashed) noexcept {
+        return dashed ? k + (k >= 8) + (k >= 12) + (k >= 16) + (k >= 20) : k;
+    }
+
+    static constexpr bool digitsValid(const char *s, size_t k, bool dashed) noexcept {
+        return k == 32 ||
+               (hexValue(s[digitPos(k, dashed)]) >= 0 && digitsValid(s, k + 1, dashed));
+    }
 
+    static constexpr uint64_t hexWord(const char *s, bool dashed, size_t k, size_t n,
+                                      uint64_t acc) noexcept {
+        return n == 0 ? acc
+                      : hexWord(s, dashed, k + 1, n - 1,
+                                (acc << 4) | (uint64_t)hexValue(s[digitPos(k, dashed)]));
+    }
+
+    static inline void load128(const uint8_t b[16], uint64_t &hi, uint64_t &lo) noexcept {
+        hi = lo = 0;
+        for (int i = 0; i < 8; i++) {
+            hi = (hi << 8) | b[i];
+            lo = (lo << 8) | b[i + 8];
+        }
+    }
+
+    static inline void store128(uint64_t hi, uint64_t lo, uint8_t b[16]) noexcept {
+        for (int i = 7; i >= 0; i--) {
+            b[i] = (uint8_t)hi;
+            b[i + 8] = (uint8_t)lo;
+            hi >>= 8;
+            lo >>= 8;
+        }
+    }
+
+#if defined(UUID7_CODEC_SSSE3)
+    // 16 bytes -> 32 hex digits in two registers (digits 0-15, 16-31).
+    static inline void hexVectors(const uint8_t bytes[16], bool uppercase, __m128i &h0,
+                                  __m128i &h1) noexcept {
+        const __m128i digits = _mm_loadu_si128(reinterpret_cast<const __m128i *>(
+            uppercase ? "0123456789ABCDEF" : "0123456789abcdef"));
+        const __m128i mask = _mm_set1_epi8(0x0F);
+        __m128i in = _mm_loadu_si128(reinterpret_cast<const __m128i *>(bytes));
+        __m128i hi = _mm_shuffle_epi8(digits, _mm_and_si128(_mm_srli_epi16(in, 4), mask));
+        __m128i lo = _mm_shuffle_epi8(digits, _mm_and_si128(in, mask));
+        h0 = _mm_unpacklo_epi8(hi, lo);
+        h1 = _mm_unpackhi_epi8(hi, lo);
+    }
+
+    static inline bool unhexVectors(__m128i c0, __m128i c1, uint8_t out[16]) noexcept {
+        __m128i bad = _mm_setzero_si128();
+        __m128i a = nibbles(c0, bad);
+        __m128i b = nibbles(c1, bad);
+        if (_mm_movemask_epi8(bad) != 0) {
+            return false;
+        }
+        // (hi << 4) + lo for each adjacent pair, then narrow to bytes.
+        const __m128i weights = _mm_set1_epi16(0x0110);
+        __m128i packed = _mm_packus_epi16(_mm_maddubs_epi16(a, weights),
+                                          _mm_maddubs_epi16(b, weights));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out), packed);
         return true;
     }
+
+    // Map ASCII hex digits to 0..15; flags any other byte in `bad`.
+    static inline __m128i nibbles(__m128i c, __m128i &bad) noexcept {
+        __m128i d = _mm_sub_epi8(c, _mm_set1_epi8('0'));
+        __m128i l = _mm_sub_epi8(_mm_or_si128(c, _mm_set1_epi8(0x20)), _mm_set1_epi8('a'));
+        __m128i is_digit = _mm_cmpeq_epi8(_mm_min_epu8(d, _mm_set1_epi8(9)), d);
+        __m128i is_alpha = _mm_cmpeq_epi8(_mm_min_epu8(l, _mm_set1_epi8(5)), l);
+        bad = _mm_or_si128(bad, _mm_andnot_si128(_mm_or_si128(is_digit, is_alpha),
+                                                 _mm_set1_epi8(-1)));
+        return _mm_or_si128(_mm_and_si128(is_digit, d),
+                            _mm_andnot_si128(is_digit, _mm_add_epi8(l, _mm_set1_epi8(10))));
+    }
+#elif defined(UUID7_CODEC_NEON)
+    static inline uint8x16_t nibbles(uint8x16_t c, uint8x16_t &ok) noexcept {
+        uint8x16_t d = vsubq_u8(c, vdupq_n_u8('0'));
+        uint8x16_t l = vsubq_u8(vorrq_u8(c, vdupq_n_u8(0x20)), vdupq_n_u8('a'));
+        uint8x16_t is_digit = vcleq_u8(d, vdupq_n_u8(9));
+        uint8x16_t is_alpha = vcleq_u8(l, vdupq_n_u8(5));
+        ok = vandq_u8(ok, vorrq_u8(is_digit, is_alpha));
+        return vbslq_u8(is_digit, d, vaddq_u8(l, vdupq_n_u8(10)));
+    }
+#endif
 };
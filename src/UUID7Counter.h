@@ -0,0 +1,166 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2026 bkwoka
+// Repository: https://github.com/bkwoka/UUIDv7
+
+#pragma once
+#include <stdint.h>
+#include <string.h>
+
+/**
+ * @brief Same-millisecond counter over the 74 random bits of a UUIDv7
+ * (12-bit rand_a followed by 62-bit rand_b).
+ *
+ * The counter is kept outside the UUID buffer and only written into it with
+ * store(), so the version and variant bits never take part in the increment.
+ * add() is non-destructive: on overflow the counter keeps its last value.
+ */
+#ifdef UUID7_OPTIMIZE_SIZE
+
+struct UUID7Counter {
+    // Bytes 6..15 of the UUID with the version/variant bits masked off.
+    uint8_t r[10];
+    bool seeded;
+
+    UUID7Counter() noexcept : seeded(false) { memset(r, 0, 10); }
+
+    static uint8_t width(int i) noexcept { return i == 0 ? 4 : (i == 2 ? 6 : 8); }
+
+    void load(const uint8_t* b) noexcept {
+        memcpy(r, b + 6, 10);
+        r[0] &= 0x0F;
+        r[2] &= 0x3F;
+        seeded = true;
+    }
+
+    void store(uint8_t* b) const noexcept {
+        b[6] = (b[6] & 0xF0) | r[0];
+        b[7] = r[1];
+        b[8] = (b[8] & 0xC0) | r[2];
+        memcpy(b + 9, r + 3, 7);
+    }
+
+    // Clear all but the low `bits` of the 74-bit field.
+    void truncate(uint8_t bits) noexcept {
+        for (int i = 9; i >= 0; i--) {
+            uint8_t w = width(i);
+            if (bits >= w) {
+                bits -= w;
+                continue;
+            }
+            r[i] &= (uint8_t)((1u << bits) - 1);
+            bits = 0;
+        }
+    }
+
+    bool add(uint32_t step) noexcept {
+        uint8_t t[10];
+        memcpy(t, r, 10);
+        uint32_t carry = step;
+        for (int i = 9; i >= 0 && carry; i--) {
+            uint8_t w = width(i);
+            uint32_t s = t[i] + carry;
+            t[i] = (uint8_t)(s & ((1u << w) - 1));
+            carry = s >> w;
+        }
+        if (carry)
+            return false;
+        memcpy(r, t, 10);
+        return true;
+    }
+
+    uint16_t randA() const noexcept { return (uint16_t)((r[0] << 8) | r[1]); }
+
+    void setRandA(uint16_t v) noexcept {
+        r[0] = (uint8_t)((v >> 8) & 0x0F);
+        r[1] = (uint8_t)(v & 0xFF);
+    }
+
+    // Top 38 bits of rand_b (r[2] low 6 bits, r[3..6]).
+    uint64_t window() const noexcept {
+        uint64_t v = r[2];
+        for (int i = 3; i < 7; i++) v = (v << 8) | r[i];
+        return v;
+    }
+
+    /** @brief Top `bits` (1..32) of rand_b, i.e. the node/shard prefix. */
+    uint32_t top(uint8_t bits) const noexcept { return (uint32_t)(window() >> (38 - bits)); }
+
+    void setTop(uint8_t bits, uint32_t id) noexcept {
+        uint8_t shift = 38 - bits;
+        uint64_t mask = (((uint64_t)1 << bits) - 1) << shift;
+        uint64_t v = (window() & ~mask) | (((uint64_t)id << shift) & mask);
+        r[2] = (uint8_t)((v >> 32) & 0x3F);
+        for (int i = 6; i >= 3; i--) {
+            r[i] = (uint8_t)(v & 0xFF);
+            v >>= 8;
+        }
+    }
+};
+
+#else
+
+struct UUID7Counter {
+    static constexpr uint64_t LO_MASK = 0x3FFFFFFFFFFFFFFFULL;
+
+    uint64_t lo; // rand_b
+    uint16_t hi; // rand_a
+    bool seeded;
+
+    UUID7Counter() noexcept : lo(0), hi(0), seeded(false) {}
+
+    void load(const uint8_t* b) noexcept {
+        hi = (uint16_t)(((b[6] & 0x0F) << 8) | b[7]);
+        uint64_t v = b[8] & 0x3F;
+        for (int i = 9; i < 16; i++) v = (v << 8) | b[i];
+        lo = v;
+        seeded = true;
+    }
+
+    void store(uint8_t* b) const noexcept {
+        b[6] = (b[6] & 0xF0) | (uint8_t)(hi >> 8);
+        b[7] = (uint8_t)(hi & 0xFF);
+        uint64_t v = lo;
+        for (int i = 15; i >= 9; i--) {
+            b[i] = (uint8_t)(v & 0xFF);
+            v >>= 8;
+        }
+        b[8] = (b[8] & 0xC0) | (uint8_t)(v & 0x3F);
+    }
+
+    // Clear all but the low `bits` of the 74-bit field.
+    void truncate(uint8_t bits) noexcept {
+        if (bits >= 74) return;
+        if (bits >= 62) {
+            hi &= (uint16_t)((1u << (bits - 62)) - 1);
+            return;
+        }
+        hi = 0;
+        lo &= (1ULL << bits) - 1;
+    }
+
+    bool add(uint32_t step) noexcept {
+        uint64_t v = lo + step;
+        if (v <= LO_MASK) {
+            lo = v;
+            return true;
+        }
+        if (hi == 0x0FFF) return false;
+        hi++;
+        lo = v & LO_MASK;
+        return true;
+    }
+
+    uint16_t randA() const noexcept { return hi; }
+    void setRandA(uint16_t v) noexcept { hi = v & 0x0FFF; }
+
+    /** @brief Top `bits` (1..32) of rand_b, i.e. the node/shard prefix. */
+    uint32_t top(uint8_t bits) const noexcept { return (uint32_t)(lo >> (62 - bits)); }
+
+    void setTop(uint8_t bits, uint32_t id) noexcept {
+        uint8_t shift = 62 - bits;
+        uint64_t mask = ((1ULL << bits) - 1) << shift;
+        lo = (lo & ~mask) | (((uint64_t)id << shift) & mask);
+    }
+};
+
+#endif
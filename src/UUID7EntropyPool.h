@@ -0,0 +1,287 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2026 bkwoka
+// Repository: https://github.com/bkwoka/UUIDv7
+
+#pragma once
+
+#include "UUID7.h"
+#include "UUID7Guard.h"
+#include "UUID7Prng.h"
+#include <string.h>
+
+/**
+ * @class UUID7EntropyPool
+ * @brief Buffered entropy source for slow hardware RNGs.
+ *
+ * Expands a 256-bit key drawn from the hardware source with ChaCha20 into a
+ * pool of PoolSize bytes, so that a generator reading from the pool pays one
+ * memcpy per call instead of per-byte hardware reads (RP2040 ROSC, AVR ADC
+ * jitter, STM32 random() + UID mix). The key is re-drawn from the hardware
+ * source every reseed interval, and extra entropy (e.g. collected by DMA) can
+ * be folded in with addEntropy(). Consumed pool bytes are wiped.
+ *
+ * Keystream blocks are reserved under the lock and computed outside of it:
+ * when the pool runs dry, a reader expands its own blocks directly into the
+ * destination. Call refill() from an idle task or loop() to keep the
+ * expansion off the generate() path entirely.
+ *
+ * @code
+ * UUID7EntropyPool<128> pool;
+ * UUID7 uuid;
+ * uuid.setRandomSource(UUID7EntropyPool<128>::fill, &pool);
+ * @endcode
+ *
+ * @tparam PoolSize Pool size in bytes (multiple of 64, the ChaCha20 block).
+ * @note If the hardware source fails its health check (all 0x00 / 0xFF) before
+ *       the first key is established, the pool outputs zeros so that the
+ *       generator's RNG fault check rejects them.
+ */
+template <size_t PoolSize = 128> class UUID7EntropyPool {
+  static_assert(PoolSize >= 64 && PoolSize % 64 == 0,
+                "UUID7EntropyPool size must be a non-zero multiple of 64");
+
+public:
+  typedef uuid7::fill_random_fn fill_random_fn;
+  typedef uuid7::lock_fn_t lock_fn_t;
+
+  /**
+   * @brief Create a pool seeded lazily from the given hardware source.
+   * @param source Hardware RNG (nullptr for UUID7::default_fill_random).
+   * @param ctx Context for source (on AVR, pass the UUID7 instance to use its
+   *        entropy analog pin).
+   * @param reseed_interval Bytes of output between hardware reseeds (0 to
+   *        disable periodic reseeding).
+   */
+  UUID7EntropyPool(fill_random_fn source = nullptr, void *ctx = nullptr,
+                   uint32_t reseed_interval = 65536) noexcept
+      : _source(source ? source : &UUID7::default_fill_random), _ctx(ctx),
+        _counter(0), _sinceReseed(0), _reseedInterval(reseed_interval),
+        _pos(PoolSize), _keyGen(0), _seeded(false), _lock_cb(nullptr),
+        _unlock_cb(nullptr) {
+    memset(_key, 0, sizeof(_key));
+    memset(_pool, 0, sizeof(_pool));
+  }
+
+  ~UUID7EntropyPool() {
+    memset(_key, 0, sizeof(_key));
+    memset(_pool, 0, sizeof(_pool));
+  }
+
+  UUID7EntropyPool(const UUID7EntropyPool &) = delete;
+  UUID7EntropyPool &operator=(const UUID7EntropyPool &) = delete;
+
+  /**
+   * @brief fill_random_fn adapter for UUID7::setRandomSource().
+   * @param ctx Pointer to the pool.
+   */
+  static void fill(uint8_t *dest, size_t len, void *ctx) noexcept {
+    static_cast<UUID7EntropyPool *>(ctx)->read(dest, len);
+  }
+
+  /**
+   * @brief Copy len bytes of pooled entropy into dest.
+   * Served from the pool with a single memcpy when enough bytes are buffered,
+   * otherwise expanded on the spot without holding the lock.
+   */
+  void read(uint8_t *dest, size_t len) noexcept {
+    uint32_t key[8];
+    uint64_t first = 0;
+    for (int attempt = 0;; attempt++) {
+      {
+        UUID7Guard lock(_lock_cb, _unlock_cb);
+        // After one reseed attempt, serve whatever key there is: a failed
+        // reseed has already backed off (see reseed()).
+        if (_seeded && (attempt || !_reseedDue())) {
+          _sinceReseed += len;
+          if (PoolSize - _pos >= len) {
+            memcpy(dest, _pool + _pos, len);
+            memset(_pool + _pos, 0, len);
+            _pos += len;
+            return;
+          }
+          first = _reserve(key, (len + 63) / 64);
+          break;
+        }
+        if (attempt) {
+          memset(dest, 0, len); // Never seeded
+          return;
+        }
+      }
+      reseed();
+    }
+
+    uint8_t block[64];
+    for (size_t off = 0; off < len; off += 64) {
+      uuid_chacha20_block(key, first++, block);
+      size_t n = (len - off < 64) ? len - off : 64;
+      memcpy(dest + off, block, n);
+    }
+    memset(block, 0, sizeof(block));
+    memset(key, 0, sizeof(key));
+  }
+
+  /**
+   * @brief Top up the pool if it is less than half full.
+   * Intended for an idle task / loop(); also performs a due hardware reseed,
+   * and the expansion runs without the lock. If the key changes meanwhile
+   * (reseed(), addEntropy()), the expanded block is dropped.
+   * @return true if the pool was refilled.
+   */
+  bool refill() noexcept {
+    bool due;
+    {
+      UUID7Guard lock(_lock_cb, _unlock_cb);
+      due = !_seeded || _reseedDue();
+    }
+    if (due)
+      reseed();
+
+    uint32_t key[8];
+    uint64_t first;
+    uint32_t gen;
+    {
+      UUID7Guard lock(_lock_cb, _unlock_cb);
+      if (!_seeded || PoolSize - _pos >= PoolSize / 2)
+        return false;
+      first = _reserve(key, PoolSize / 64);
+      gen = _keyGen;
+    }
+
+    uint8_t fresh[PoolSize];
+    for (size_t off = 0; off < PoolSize; off += 64) {
+      uuid_chacha20_block(key, first++, fresh + off);
+    }
+    bool installed;
+    {
+      UUID7Guard lock(_lock_cb, _unlock_cb);
+      // A reseed or addEntropy() in the meantime discarded the buffered
+      // output; do not reinstall output of the key it replaced.
+      installed = (gen == _keyGen);
+      if (installed) {
+        memcpy(_pool, fresh, PoolSize);
+        _pos = 0;
+      }
+    }
+    memset(fresh, 0, sizeof(fresh));
+    memset(key, 0, sizeof(key));
+    return installed;
+  }
+
+  /**
+   * @brief Draw a new key contribution from the hardware source now.
+   * A draw that fails the health check is discarded and the current key
+   * kept; the next automatic attempt then waits kReseedRetryBytes of output
+   * instead of hitting the hardware source on every read().
+   * @return false if the draw failed the health check.
+   */
+  bool reseed() noexcept {
+    uint8_t fresh[32];
+    _source(fresh, sizeof(fresh), _ctx);
+
+    uint8_t sum_or = 0, sum_and = 0xFF;
+    for (size_t i = 0; i < sizeof(fresh); i++) {
+      sum_or |= fresh[i];
+      sum_and &= fresh[i];
+    }
+    bool ok = sum_or != 0 && sum_and != 0xFF;
+    {
+      UUID7Guard lock(_lock_cb, _unlock_cb);
+      if (ok) {
+        _mixLocked(fresh, sizeof(fresh));
+        _seeded = true;
+        _sinceReseed = 0;
+      } else if (_reseedInterval > kReseedRetryBytes) {
+        _sinceReseed = _reseedInterval - kReseedRetryBytes;
+      } else {
+        _sinceReseed = 0;
+      }
+    }
+    memset(fresh, 0, sizeof(fresh));
+    return ok;
+  }
+
+  /**
+   * @brief Fold caller-supplied entropy (e.g. a DMA-filled ADC buffer) into
+   * the key. Buffered output is discarded.
+   * @note Does not by itself mark the pool as seeded.
+   */
+  void addEntropy(const uint8_t *data, size_t len) noexcept {
+    if (!data || len == 0)
+      return;
+    UUID7Guard lock(_lock_cb, _unlock_cb);
+    _mixLocked(data, len);
+  }
+
+  /** @brief Set the number of output bytes between hardware reseeds. */
+  void setReseedInterval(uint32_t bytes) {
+    UUID7Guard lock(_lock_cb, _unlock_cb);
+    _reseedInterval = bytes;
+  }
+
+  /**
+   * @brief Inject custom lock/unlock callbacks (default: UUID7Guard).
+   */
+  void setLockCallbacks(lock_fn_t lock_cb, lock_fn_t unlock_cb) {
+    bool both = (lock_cb != nullptr) && (unlock_cb != nullptr);
+    _lock_cb = both ? lock_cb : nullptr;
+    _unlock_cb = both ? unlock_cb : nullptr;
+  }
+
+  /** @brief Number of buffered bytes ready to be served with one memcpy. */
+  size_t available() const noexcept {
+    UUID7Guard lock(_lock_cb, _unlock_cb);
+    return PoolSize - _pos;
+  }
+
+  /** @brief Output bytes before a failed reseed is retried. */
+  static constexpr uint32_t kReseedRetryBytes = 1024;
+
+  /** @brief Pool capacity in bytes. */
+  static constexpr size_t capacity() { return PoolSize; }
+
+private:
+  fill_random_fn _source;
+  void *_ctx;
+  uint32_t _key[8];
+  uint64_t _counter; // Next unused ChaCha20 block for the current key
+  uint32_t _sinceReseed;
+  uint32_t _reseedInterval;
+  size_t _pos; // First unread byte in _pool
+  uint32_t _keyGen; // Bumped whenever the key changes
+  bool _seeded;
+  lock_fn_t _lock_cb;
+  lock_fn_t _unlock_cb;
+  uint8_t _pool[PoolSize];
+
+  bool _reseedDue() const noexcept {
+    return _reseedInterval != 0 && _sinceReseed >= _reseedInterval;
+  }
+
+  // Snapshot the key and reserve `blocks` counter values. Caller holds lock.
+  uint64_t _reserve(uint32_t key[8], size_t blocks) noexcept {
+    memcpy(key, _key, sizeof(_key));
+    uint64_t first = _counter;
+    _counter += blocks;
+    return first;
+  }
+
+  // Absorb data 32 bytes at a time: XOR into the key, then replace the key
+  // with the first half of a keystream block. Caller holds lock.
+  void _mixLocked(const uint8_t *data, size_t len) noexcept {
+    uint8_t block[64];
+    for (size_t off = 0; off < len; off += 32) {
+      for (size_t i = 0; i < 32 && off + i < len; i++)
+        _key[i / 4] ^= (uint32_t)data[off + i] << ((i % 4) * 8);
+      uuid_chacha20_block(_key, _counter++, block);
+      for (int i = 0; i < 8; i++) {
+        _key[i] = (uint32_t)block[i * 4] | ((uint32_t)block[i * 4 + 1] << 8) |
+                  ((uint32_t)block[i * 4 + 2] << 16) |
+                  ((uint32_t)block[i * 4 + 3] << 24);
+      }
+    }
+    memset(block, 0, sizeof(block));
+    memset(_pool, 0, sizeof(_pool));
+    _pos = PoolSize;
+    _keyGen++;
+  }
+};
@@ -18,13 +18,27 @@ extern portMUX_TYPE _uuid_spinlock;
 extern spin_lock_t *_uuid_rp2040_spinlock;
 #elif defined(PLATFORMIO_NATIVE)
 #include <mutex>
+#include <thread>
 extern std::mutex _uuid_mutex;
 #endif
 
 class UUID7Guard {
 public:
-  inline UUID7Guard(void (*lock_cb)(void), void (*unlock_cb)(void))
-      : _lock_cb(lock_cb), _unlock_cb(unlock_cb) {
+  /**
+   * @param lock_cb, unlock_cb Context-free callbacks (nullptr for the
+   *        platform default).
+   * @param lock_ctx_cb, unlock_ctx_cb Callbacks taking ctx; take precedence
+   *        over lock_cb/unlock_cb when set.
+   */
+  inline UUID7Guard(void (*lock_cb)(void), void (*unlock_cb)(void),
+                    void (*lock_ctx_cb)(void *) = nullptr,
+                    void (*unlock_ctx_cb)(void *) = nullptr, void *ctx = nullptr)
+      : _lock_cb(lock_cb), _unlock_cb(unlock_cb), _unlock_ctx_cb(unlock_ctx_cb),
+        _ctx(ctx) {
+    if (_unlock_ctx_cb) {
+      lock_ctx_cb(_ctx);
+      return;
+    }
     if (_lock_cb) {
       _lock_cb();
       return;
@@ -49,6 +63,10 @@ public:
   }
 
   inline ~UUID7Guard() {
+    if (_unlock_ctx_cb) {
+      _unlock_ctx_cb(_ctx);
+      return;
+    }
     if (_unlock_cb) {
       _unlock_cb();
       return;
@@ -77,9 +95,48 @@ public:
 private:
   void (*_lock_cb)(void);
   void (*_unlock_cb)(void);
+  void (*_unlock_ctx_cb)(void *);
+  void *_ctx;
 #if defined(ARDUINO_ARCH_AVR) || defined(__AVR__)
   uint8_t _sreg;
 #elif defined(ARDUINO_ARCH_RP2040) && defined(PICO_SDK_VERSION_MAJOR)
   uint32_t _saved_irq = 0;
 #endif
 };
+
+/**
+ * @brief Minimal per-object lock for callers that need more than the single
+ * process-wide guard (see UUID7Sharded). Available where UUID7_HAS_SPINLOCK
+ * is defined: a portMUX critical section on ESP32, a test-and-set spinlock
+ * yielding to the scheduler on native.
+ */
+#if defined(PLATFORMIO_ESP32) || defined(ARDUINO_ARCH_ESP32)
+#define UUID7_HAS_SPINLOCK
+class UUID7SpinLock {
+public:
+  UUID7SpinLock() {
+    portMUX_TYPE init = portMUX_INITIALIZER_UNLOCKED;
+    _mux = init;
+  }
+  inline void lock() { portENTER_CRITICAL_SAFE(&_mux); }
+  inline void unlock() { portEXIT_CRITICAL_SAFE(&_mux); }
+
+private:
+  portMUX_TYPE _mux;
+};
+#elif defined(PLATFORMIO_NATIVE)
+#define UUID7_HAS_SPINLOCK
+class UUID7SpinLock {
+public:
+  UUID7SpinLock() : _flag(0) {}
+  inline void lock() {
+    while (__atomic_test_and_set(&_flag, __ATOMIC_ACQUIRE)) {
+      std::this_thread::yield();
+    }
+  }
+  inline void unlock() { __atomic_clear(&_flag, __ATOMIC_RELEASE); }
+
+private:
+  bool _flag;
+};
+#endif
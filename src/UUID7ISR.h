@@ -0,0 +1,305 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2026 bkwoka
+// Repository: https://github.com/bkwoka/UUIDv7
+
+#pragma once
+
+#include "UUID7.h"
+#include <string.h>
+
+// The slot reservation is one lock-free fetch-and-add where the target has
+// one, otherwise a read-modify-write with interrupts masked. There is no
+// third option: a plain increment can hand two handlers the same slot.
+#if defined(__GCC_ATOMIC_INT_LOCK_FREE) && (__GCC_ATOMIC_INT_LOCK_FREE == 2)
+#define UUID7_ISR_ATOMIC32
+#elif defined(ARDUINO_ARCH_AVR) || defined(__AVR__)
+#include <avr/interrupt.h>
+#define UUID7_ISR_IRQ_MASK
+#elif defined(ARDUINO_ARCH_RP2040) && defined(PICO_SDK_VERSION_MAJOR)
+#include <hardware/sync.h>
+#define UUID7_ISR_IRQ_MASK
+#elif defined(__ARM_ARCH_6M__)
+#define UUID7_ISR_IRQ_MASK
+#elif defined(PLATFORMIO_ESP8266) || defined(ESP8266)
+#include <Arduino.h>
+#define UUID7_ISR_IRQ_MASK
+#else
+#error "UUID7ISR: no lock-free 32-bit atomics and no interrupt mask for this target"
+#endif
+
+/**
+ * @class UUID7ISR
+ * @brief Wait-free v7 generation for interrupt handlers.
+ *
+ * generateFromISR() calls no callback and takes no lock: it reserves a
+ * (millisecond, sequence) slot with one 32-bit fetch-and-add, reads the
+ * millisecond last published by tick() and whitens a word of a pool that
+ * refill() drew from the RNG beforehand. Its cost is a fixed instruction
+ * sequence, so interrupt latency stays deterministic.
+ *
+ * Layout: 48-bit tick timestamp, a 12-bit per-millisecond sequence in
+ * rand_a (up to 4096 IDs per tick), the node ID (if any) in the top bits of
+ * rand_b, pool entropy below it. IDs from one UUID7ISR are strictly
+ * increasing; against a task-side UUID7 they are ordered by millisecond
+ * only. Give the two different node IDs (UUID7::setNodeId() and
+ * setNodeId() here) to make their IDs disjoint by construction.
+ *
+ * @code
+ * UUID7ISR<> isr;
+ * void setup() { isr.begin(epoch_ms + millis()); attachInterrupt(PIN, onEdge, RISING); }
+ * void onTimer() { isr.tick(epoch_ms + millis()); } // 1 ms timer / SysTick hook
+ * void onEdge() { isr.generateFromISR(events[head++ & 63]); }
+ * void loop() { isr.refill(); }
+ * @endcode
+ *
+ * @tparam PoolWords Number of 64-bit pool words (power of two).
+ * @note Targets without lock-free 32-bit atomics mask interrupts for the
+ *       few instructions of the reservation instead: AVR (SREG), ARMv6-M
+ *       such as SAMD21, STM32F0/L0, nRF51 and RP2040 (PRIMASK) and ESP8266
+ *       (xt_rsil). The mask only covers the calling core, so on RP2040 use
+ *       one instance per core. Other targets without atomics do not compile.
+ * @note The tick timestamp is not checked against the persistence
+ *       high-water mark; tick() only guarantees it never moves backwards.
+ */
+template <size_t PoolWords = 8> class UUID7ISR {
+  static_assert(PoolWords > 0 && (PoolWords & (PoolWords - 1)) == 0,
+                "UUID7ISR pool size must be a power of two");
+
+public:
+  typedef uuid7::fill_random_fn fill_random_fn;
+
+  /** @brief Lock-free fetch-and-add reservation (false: interrupts masked). */
+#if defined(UUID7_ISR_ATOMIC32)
+  static constexpr bool kAtomicReservation = true;
+#else
+  static constexpr bool kAtomicReservation = false;
+#endif
+#if defined(UUID7_ISR_IRQ_MASK)
+  static constexpr bool kMaskedReservation = true;
+#else
+  static constexpr bool kMaskedReservation = false;
+#endif
+  static_assert(kAtomicReservation != kMaskedReservation,
+                "UUID7ISR reservation must be exactly one of atomic or masked");
+
+  /** @brief IDs available per tick millisecond. */
+  static constexpr uint32_t kPerMs = 4096;
+
+  /**
+   * @param source RNG used by refill() (nullptr for
+   *        UUID7::default_fill_random). Never called from generateFromISR().
+   * @param ctx Context for source.
+   */
+  UUID7ISR(fill_random_fn source = nullptr, void *ctx = nullptr) noexcept
+      : _source(source ? source : &UUID7::default_fill_random), _ctx(ctx),
+        _state(0), _msIdx(0), _ready(0), _prefixBits(0), _prefix(0) {
+    _ms[0] = _ms[1] = 0;
+    memset(_pool, 0, sizeof(_pool));
+  }
+
+  ~UUID7ISR() { memset(_pool, 0, sizeof(_pool)); }
+
+  UUID7ISR(const UUID7ISR &) = delete;
+  UUID7ISR &operator=(const UUID7ISR &) = delete;
+
+  /**
+   * @brief Fill the pool and publish the first millisecond. Call from task
+   * context before enabling the interrupts that generate.
+   * @return false if the RNG failed its health check (generateFromISR()
+   *         keeps failing until a refill() succeeds).
+   */
+  bool begin(uint64_t now_ms) noexcept {
+    bool ok = refill();
+    tick(now_ms);
+    return ok;
+  }
+
+  /**
+   * @brief Publish the current Unix time in ms. Call from a 1 ms timer or
+   * SysTick hook, or as often as the required resolution demands. Values
+   * not greater than the last published one are ignored.
+   * @note Single writer: call from one context only.
+   */
+  void tick(uint64_t now_ms) noexcept {
+    now_ms &= 0x0000FFFFFFFFFFFFULL;
+    IrqMask mask;
+    uint32_t i = _load(&_msIdx);
+    if (now_ms <= _loadMs(&_ms[i & 1]))
+      return;
+    // Double-buffered so that a reader never sees a half-written slot.
+    _storeMs(&_ms[(i + 1) & 1], now_ms);
+    _store(&_msIdx, i + 1);
+    _store(&_state, (uint32_t)(now_ms & 0xFFFF) << 16);
+  }
+
+  /**
+   * @brief Generate one v7 ID. Safe in interrupt handlers and from several
+   * cores at once; never blocks, retries or calls out.
+   * @return false before begin(), when the pool was never filled, or when
+   *         the current tick's 4096 IDs are used up (out is untouched).
+   */
+  bool generateFromISR(uint8_t out[16]) noexcept {
+    uint64_t ms;
+    uint32_t slot;
+    {
+      IrqMask mask;
+      slot = _fetchAdd(&_state);
+      ms = _loadMs(&_ms[_load(&_msIdx) & 1]);
+    }
+    uint32_t seq = slot & 0xFFFF;
+    // A tick between the two reads moved the slot forward; step back to the
+    // millisecond the sequence number belongs to. A sequence that carried
+    // into the millisecond bits appears to lead the slot and is rejected.
+    uint16_t lag = (uint16_t)((uint16_t)ms - (uint16_t)(slot >> 16));
+    if (!_load(&_ready) || ms == 0 || seq >= kPerMs || lag >= 0x8000)
+      return false;
+    ms -= lag;
+
+    uint64_t x = _pool[(slot ^ (slot >> 16)) & (PoolWords - 1)] ^
+                 (ms * 0x9E3779B97F4A7C15ULL) ^ ((uint64_t)seq << 40);
+    x ^= x >> 31;
+    x *= 0xBF58476D1CE4E5B9ULL;
+    x ^= x >> 29;
+    uint64_t rand_b = x >> 2;
+    if (_prefixBits) {
+      uint8_t shift = (uint8_t)(62 - _prefixBits);
+      rand_b = (rand_b & ((1ULL << shift) - 1)) | ((uint64_t)_prefix << shift);
+    }
+
+    for (int i = 5; i >= 0; i--) {
+      out[i] = (uint8_t)(ms & 0xFF);
+      ms >>= 8;
+    }
+    out[6] = (uint8_t)(0x70 | (seq >> 8));
+    out[7] = (uint8_t)seq;
+    out[8] = (uint8_t)(0x80 | ((rand_b >> 56) & 0x3F));
+    for (int i = 15; i >= 9; i--) {
+      out[i] = (uint8_t)(rand_b & 0xFF);
+      rand_b >>= 8;
+    }
+    return true;
+  }
+
+  /**
+   * @brief Redraw the pool from the RNG. Task context only (loop(), an idle
+   * task); generateFromISR() may run concurrently and mixes old and new
+   * words harmlessly. A draw that fails the health check is discarded.
+   * @return true if the pool holds RNG output.
+   */
+  bool refill() noexcept {
+    uint64_t fresh[PoolWords];
+    _source(reinterpret_cast<uint8_t *>(fresh), sizeof(fresh), _ctx);
+    const uint8_t *p = reinterpret_cast<const uint8_t *>(fresh);
+    uint8_t sum_or = 0, sum_and = 0xFF;
+    for (size_t i = 0; i < sizeof(fresh); i++) {
+      sum_or |= p[i];
+      sum_and &= p[i];
+    }
+    if (sum_or != 0 && sum_and != 0xFF) {
+      memcpy(_pool, fresh, sizeof(fresh));
+      _store(&_ready, 1);
+    }
+    memset(fresh, 0, sizeof(fresh));
+    return _load(&_ready) != 0;
+  }
+
+  /**
+   * @brief Stamp a node ID into the top bits of rand_b, as
+   * UUID7::setNodeId() does. Call before begin().
+   * @param id Node ID; must fit in bits.
+   * @param bits 1..28, or 0 to remove the node ID.
+   * @return false if the arguments do not fit (configuration unchanged).
+   */
+  bool setNodeId(uint32_t id, uint8_t bits) noexcept {
+    if (bits > 28 || (id >> bits) != 0)
+      return false;
+    _prefixBits = bits;
+    _prefix = bits ? id : 0;
+    return true;
+  }
+
+  /** @brief Last published millisecond (0 before the first tick). */
+  uint64_t lastTick() const noexcept {
+    IrqMask mask;
+    return _loadMs(&_ms[_load(&_msIdx) & 1]);
+  }
+
+private:
+  // Masks interrupts where the reservation cannot be a single atomic
+  // instruction; a no-op elsewhere.
+  struct IrqMask {
+#if defined(UUID7_ISR_ATOMIC32)
+    IrqMask() noexcept {}
+#elif defined(ARDUINO_ARCH_AVR) || defined(__AVR__)
+    IrqMask() noexcept : sreg(SREG) { cli(); }
+    ~IrqMask() { SREG = sreg; }
+    uint8_t sreg;
+#elif defined(ARDUINO_ARCH_RP2040) && defined(PICO_SDK_VERSION_MAJOR)
+    IrqMask() noexcept : saved(save_and_disable_interrupts()) {}
+    ~IrqMask() { restore_interrupts(saved); }
+    uint32_t saved;
+#elif defined(__ARM_ARCH_6M__)
+    IrqMask() noexcept {
+      __asm__ volatile("mrs %0, primask" : "=r"(primask));
+      __asm__ volatile("cpsid i" ::: "memory");
+    }
+    ~IrqMask() { __asm__ volatile("msr primask, %0" ::"r"(primask) : "memory"); }
+    uint32_t primask;
+#elif defined(PLATFORMIO_ESP8266) || defined(ESP8266)
+    IrqMask() noexcept : ps(xt_rsil(15)) {}
+    ~IrqMask() { xt_wsr_ps(ps); }
+    uint32_t ps;
+#endif
+  };
+
+  static uint32_t _fetchAdd(uint32_t *p) noexcept {
+#if defined(UUID7_ISR_ATOMIC32)
+    return __atomic_fetch_add(p, 1, __ATOMIC_ACQ_REL);
+#else
+    return (*(volatile uint32_t *)p)++;
+#endif
+  }
+
+  static uint32_t _load(const uint32_t *p) noexcept {
+#if defined(UUID7_ISR_ATOMIC32)
+    return __atomic_load_n(p, __ATOMIC_ACQUIRE);
+#else
+    return *(const volatile uint32_t *)p;
+#endif
+  }
+
+  static void _store(uint32_t *p, uint32_t v) noexcept {
+#if defined(UUID7_ISR_ATOMIC32)
+    __atomic_store_n(p, v, __ATOMIC_RELEASE);
+#else
+    *(volatile uint32_t *)p = v;
+#endif
+  }
+
+  // Plain accesses on 32-bit MCUs: the double buffer keeps them consistent.
+  static uint64_t _loadMs(const uint64_t *p) noexcept {
+#if defined(UUID7_HAS_ATOMIC64)
+    return uuid7::atomic::loadRelaxed(p);
+#else
+    return *(const volatile uint64_t *)p;
+#endif
+  }
+
+  static void _storeMs(uint64_t *p, uint64_t v) noexcept {
+#if defined(UUID7_HAS_ATOMIC64)
+    __atomic_store_n(p, v, __ATOMIC_RELAXED);
+#else
+    *(volatile uint64_t *)p = v;
+#endif
+  }
+
+  fill_random_fn _source;
+  void *_ctx;
+  uint32_t _state; // (ms & 0xFFFF) << 16 | next sequence number
+  uint32_t _msIdx; // _ms[_msIdx & 1] is the published millisecond
+  uint64_t _ms[2];
+  uint32_t _ready; // Pool holds RNG output
+  uint8_t _prefixBits;
+  uint32_t _prefix;
+  uint64_t _pool[PoolWords];
+};
@@ -0,0 +1,195 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2026 bkwoka
+// Repository: https://github.com/bkwoka/UUIDv7
+
+#pragma once
+#include "UUID7Codec.h"
+#include "UUID7Key.h"
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#if !defined(ARDUINO)
+#include <functional>
+#include <type_traits>
+#endif
+
+// 16-byte alignment keeps every ID inside one cache line and allows aligned
+// vector loads; AVR has no use for it and cannot spare the padding.
+#if defined(__AVR__)
+#define UUID7_ID_ALIGN
+#else
+#define UUID7_ID_ALIGN alignas(16)
+#endif
+
+namespace uuid7 {
+
+/** @brief NUL-terminated 36-character string returned by Id::str(). */
+struct IdString {
+    char s[37];
+    constexpr const char *c_str() const noexcept { return s; }
+};
+
+namespace detail {
+// Deliberately not constexpr: reaching it while evaluating a constant
+// (a malformed "..."_uuid7 literal) turns into a compile error naming it.
+inline uint64_t uuid_literal_is_malformed() noexcept { return 0; }
+} // namespace detail
+
+/**
+ * @brief Plain 16-byte UUID value, independent of the generator.
+ *
+ * Holds only the RFC 9562 byte layout: trivially copyable, 16 bytes, and
+ * ordered like memcmp (v7 IDs sort by timestamp). Use it to store, compare
+ * and serialize IDs; a UUID7 object also carries its RNG, clock and
+ * monotonicity state and is several times larger.
+ *
+ * @code
+ * uuid7::Id ids[64];
+ * for (auto &id : ids) uuid.generate(id);
+ * char str[37];
+ * ids[0].toString(str, sizeof(str));
+ * @endcode
+ */
+struct UUID7_ID_ALIGN Id {
+    uint8_t b[16];
+
+    /** @brief Uninitialized, like a plain array (use Id::nil() for zeros). */
+    Id() noexcept = default;
+
+    /** @brief From the two big-endian 64-bit halves (constexpr). */
+    constexpr Id(uint64_t hi, uint64_t lo) noexcept
+        : b{(uint8_t)(hi >> 56), (uint8_t)(hi >> 48), (uint8_t)(hi >> 40),
+            (uint8_t)(hi >> 32), (uint8_t)(hi >> 24), (uint8_t)(hi >> 16),
+            (uint8_t)(hi >> 8),  (uint8_t)hi,         (uint8_t)(lo >> 56),
+            (uint8_t)(lo >> 48), (uint8_t)(lo >> 40), (uint8_t)(lo >> 32),
+            (uint8_t)(lo >> 24), (uint8_t)(lo >> 16), (uint8_t)(lo >> 8),
+            (uint8_t)lo} {}
+
+    /** @brief All-zero (nil) UUID. */
+    static constexpr Id nil() noexcept { return Id(0, 0); }
+
+    /**
+     * @brief Parse a 36- or 32-character string of known length at compile
+     * time. A malformed string is a compile error in a constant expression
+     * and yields nil at run time (use parse() to detect errors instead).
+     */
+    static constexpr Id fromString(const char *str, size_t len) noexcept {
+        return UUID7Codec::isValid(str, len)
+                   ? Id(UUID7Codec::decodeHalf(str, len, 0),
+                        UUID7Codec::decodeHalf(str, len, 1))
+                   : Id(detail::uuid_literal_is_malformed(), 0);
+    }
+
+    static Id fromBytes(const uint8_t bytes[16]) noexcept {
+        Id id;
+        memcpy(id.b, bytes, 16);
+        return id;
+    }
+
+    static Id fromKey(const UUID7Key &k) noexcept { return Id(k.hi, k.lo); }
+
+    UUID7Key key() const noexcept { return UUID7Key::fromBytes(b); }
+
+    const uint8_t *data() const noexcept { return b; }
+    uint8_t *data() noexcept { return b; }
+    uint8_t operator[](size_t i) const noexcept { return b[i]; }
+
+    bool isNil() const noexcept {
+        uint8_t acc = 0;
+        for (int i = 0; i < 16; i++)
+            acc |= b[i];
+        return acc == 0;
+    }
+
+    /** @brief Version nibble (7 or 4 for generated IDs). */
+    uint8_t version() const noexcept { return (uint8_t)(b[6] >> 4); }
+
+    /** @brief Embedded 48-bit Unix timestamp (ms); meaningful for v7 only. */
+    uint64_t timestamp() const noexcept {
+        uint64_t ts = 0;
+        for (int i = 0; i < 6; i++)
+            ts = (ts << 8) | b[i];
+        return ts;
+    }
+
+    /** @brief Same hash as UUID7Key::hash(). */
+    uint64_t hash() const noexcept { return key().hash(); }
+
+    /**
+     * @brief Format as 36 (dashed) or 32 characters plus terminator.
+     * @return false if buflen is too small.
+     */
+    bool toString(char *out, size_t buflen, bool uppercase = false,
+                  bool dashes = true) const noexcept {
+        return UUID7Codec::encode(b, out, buflen, uppercase, dashes);
+    }
+
+    /** @brief Dashed form by value; constexpr under C++14 and later. */
+    UUID7_CONSTEXPR14 IdString str(bool uppercase = false) const noexcept {
+        IdString out{};
+        size_t p = 0;
+        for (int i = 0; i < 16; i++) {
+            if (i == 4 || i == 6 || i == 8 || i == 10)
+                out.s[p++] = '-';
+            out.s[p++] = UUID7Codec::hexDigit(b[i] >> 4, uppercase);
+            out.s[p++] = UUID7Codec::hexDigit(b[i] & 0x0F, uppercase);
+        }
+        out.s[36] = '\0';
+        return out;
+    }
+
+    bool toBase32(char *out, size_t buflen) const noexcept {
+        return UUID7Codec::encodeBase32(b, out, buflen);
+    }
+
+    bool toBase64Url(char *out, size_t buflen) const noexcept {
+        return UUID7Codec::encodeBase64Url(b, out, buflen);
+    }
+
+    /** @brief Parse a 36- or 32-character NUL-terminated string. */
+    static bool parse(const char *str, Id &out) noexcept {
+        return UUID7Codec::decode(str, out.b);
+    }
+
+    /** @brief Parse a 36- or 32-character string of known length. */
+    static bool parse(const char *str, size_t len, Id &out) noexcept {
+        return UUID7Codec::decode(str, len, out.b);
+    }
+
+    bool operator==(const Id &o) const noexcept { return memcmp(b, o.b, 16) == 0; }
+    bool operator!=(const Id &o) const noexcept { return !(*this == o); }
+    bool operator<(const Id &o) const noexcept { return memcmp(b, o.b, 16) < 0; }
+    bool operator>(const Id &o) const noexcept { return o < *this; }
+    bool operator<=(const Id &o) const noexcept { return !(o < *this); }
+    bool operator>=(const Id &o) const noexcept { return !(*this < o); }
+};
+
+static_assert(sizeof(Id) == 16, "uuid7::Id must be exactly 16 bytes");
+
+#if !defined(ARDUINO)
+static_assert(std::is_trivially_copyable<Id>::value,
+              "uuid7::Id must be trivially copyable");
+#endif
+
+inline namespace literals {
+/**
+ * @brief Compile-time UUID constant:
+ * `constexpr uuid7::Id NS = "0190a1b2-c3d4-7e5f-8123-456789abcdef"_uuid7;`
+ */
+constexpr Id operator"" _uuid7(const char *str, size_t len) noexcept {
+    return Id::fromString(str, len);
+}
+} // namespace literals
+
+} // namespace uuid7
+
+#if !defined(ARDUINO)
+namespace std {
+template <> struct hash<uuid7::Id> {
+    size_t operator()(const uuid7::Id &id) const noexcept {
+        return (size_t)id.hash();
+    }
+};
+} // namespace std
+#endif
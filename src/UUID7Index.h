@@ -0,0 +1,142 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2026 bkwoka
+// Repository: https://github.com/bkwoka/UUIDv7
+
+#pragma once
+#include "UUID7Key.h"
+#include <string.h>
+
+/**
+ * @class UUID7Index
+ * @brief Sorted set of UUID7Key values over caller-provided storage, with
+ * timestamp-range queries on the embedded v7 timestamp.
+ *
+ * Keys live in one contiguous sorted array (16 bytes each, no per-node
+ * overhead, no allocation). Lookups use a branchless binary search. Because
+ * v7 IDs arrive almost sorted, insert() takes an O(1) append path for keys
+ * greater than the current maximum and only shifts the tail for late
+ * arrivals. eraseBefore() drops expired entries from the front.
+ *
+ * @code
+ * static UUID7Key storage[100000];
+ * UUID7Index index(storage, 100000);
+ * index.insert(uuid.data());
+ * for (const UUID7Key &k : index.between(t1, t2)) { ... }
+ * @endcode
+ */
+class UUID7Index {
+public:
+    /** @brief Contiguous view of keys [first, last). */
+    struct Range {
+        const UUID7Key *first;
+        const UUID7Key *last;
+        const UUID7Key *begin() const noexcept { return first; }
+        const UUID7Key *end() const noexcept { return last; }
+        size_t size() const noexcept { return (size_t)(last - first); }
+        bool empty() const noexcept { return first == last; }
+    };
+
+    UUID7Index(UUID7Key *storage, size_t capacity) noexcept
+        : _keys(storage), _cap(storage ? capacity : 0), _n(0) {}
+
+    size_t size() const noexcept { return _n; }
+    size_t capacity() const noexcept { return _cap; }
+    bool empty() const noexcept { return _n == 0; }
+    void clear() noexcept { _n = 0; }
+
+    const UUID7Key &operator[](size_t i) const noexcept { return _keys[i]; }
+    const UUID7Key *begin() const noexcept { return _keys; }
+    const UUID7Key *end() const noexcept { return _keys + _n; }
+
+    /**
+     * @brief Insert a key, keeping the array sorted.
+     * @return false if the key is already present or the index is full.
+     */
+    bool insert(const UUID7Key &k) noexcept {
+        if (_n == _cap)
+            return false;
+        if (_n == 0 || _keys[_n - 1] < k) {
+            _keys[_n++] = k; // In-order v7 arrival
+            return true;
+        }
+        size_t pos = lowerBound(k);
+        if (_keys[pos] == k)
+            return false;
+        memmove(_keys + pos + 1, _keys + pos, (_n - pos) * sizeof(UUID7Key));
+        _keys[pos] = k;
+        _n++;
+        return true;
+    }
+
+    bool insert(const uint8_t bytes[16]) noexcept {
+        return insert(UUID7Key::fromBytes(bytes));
+    }
+
+    /** @brief Check whether a key is present. */
+    bool contains(const UUID7Key &k) const noexcept {
+        size_t pos = lowerBound(k);
+        return pos < _n && _keys[pos] == k;
+    }
+
+    /** @brief Remove a key. @return false if it was not present. */
+    bool erase(const UUID7Key &k) noexcept {
+        size_t pos = lowerBound(k);
+        if (pos == _n || _keys[pos] != k)
+            return false;
+        memmove(_keys + pos, _keys + pos + 1, (_n - pos - 1) * sizeof(UUID7Key));
+        _n--;
+        return true;
+    }
+
+    /**
+     * @brief Drop all keys with a timestamp before ts_ms.
+     * @return Number of keys removed.
+     */
+    size_t eraseBefore(uint64_t ts_ms) noexcept {
+        size_t pos = lowerBound(UUID7Key::minForTimestamp(ts_ms));
+        if (pos) {
+            memmove(_keys, _keys + pos, (_n - pos) * sizeof(UUID7Key));
+            _n -= pos;
+        }
+        return pos;
+    }
+
+    /** @brief Index of the first key not less than k (size() if none). */
+    size_t lowerBound(const UUID7Key &k) const noexcept {
+        if (_n == 0)
+            return 0;
+        const UUID7Key *base = _keys;
+        size_t len = _n;
+        while (len > 1) {
+            size_t half = len / 2;
+            // Conditional move instead of a data-dependent branch.
+            base = (base[half] < k) ? base + half : base;
+            len -= half;
+        }
+        return (size_t)(base - _keys) + (*base < k);
+    }
+
+    /** @brief All keys with t1_ms <= timestamp <= t2_ms, in order. */
+    Range between(uint64_t t1_ms, uint64_t t2_ms) const noexcept {
+        Range r;
+        if (t2_ms < t1_ms) {
+            r.first = r.last = _keys + _n;
+            return r;
+        }
+        r.first = _keys + lowerBound(UUID7Key::minForTimestamp(t1_ms));
+        r.last = (t2_ms >= 0x0000FFFFFFFFFFFFULL)
+                     ? _keys + _n
+                     : _keys + lowerBound(UUID7Key::minForTimestamp(t2_ms + 1));
+        return r;
+    }
+
+    /** @brief Number of keys with t1_ms <= timestamp <= t2_ms. */
+    size_t countBetween(uint64_t t1_ms, uint64_t t2_ms) const noexcept {
+        return between(t1_ms, t2_ms).size();
+    }
+
+private:
+    UUID7Key *_keys;
+    size_t _cap;
+    size_t _n;
+};
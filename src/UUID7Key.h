@@ -0,0 +1,102 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2026 bkwoka
+// Repository: https://github.com/bkwoka/UUIDv7
+
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+#if !defined(ARDUINO)
+#include <functional>
+#endif
+
+/**
+ * @brief 16-byte UUID value held as two big-endian 64-bit halves.
+ *
+ * Ordering the halves numerically equals the byte-wise (memcmp) order of the
+ * UUID, so v7 keys sort by timestamp. Compare and hash are two word
+ * operations instead of a 16-byte memcmp; use it instead of UUID7 objects as
+ * a map or index key.
+ */
+struct UUID7Key {
+    uint64_t hi; // Bytes 0..7: 48-bit timestamp, version, rand_a
+    uint64_t lo; // Bytes 8..15: variant, rand_b
+
+    UUID7Key() noexcept : hi(0), lo(0) {}
+    UUID7Key(uint64_t h, uint64_t l) noexcept : hi(h), lo(l) {}
+
+    static UUID7Key fromBytes(const uint8_t b[16]) noexcept {
+        uint64_t h = 0, l = 0;
+        for (int i = 0; i < 8; i++) {
+            h = (h << 8) | b[i];
+            l = (l << 8) | b[8 + i];
+        }
+        return UUID7Key(h, l);
+    }
+
+    void toBytes(uint8_t out[16]) const noexcept {
+        uint64_t h = hi, l = lo;
+        for (int i = 7; i >= 0; i--) {
+            out[i] = (uint8_t)h;
+            out[8 + i] = (uint8_t)l;
+            h >>= 8;
+            l >>= 8;
+        }
+    }
+
+    /** @brief Embedded 48-bit Unix timestamp (ms); meaningful for v7 only. */
+    uint64_t timestamp() const noexcept { return hi >> 16; }
+
+    /** @brief Version nibble. */
+    uint8_t version() const noexcept { return (uint8_t)((hi >> 12) & 0x0F); }
+
+    /** @brief Smallest key with the given timestamp. */
+    static UUID7Key minForTimestamp(uint64_t ms) noexcept {
+        return UUID7Key((ms & 0x0000FFFFFFFFFFFFULL) << 16, 0);
+    }
+
+    /** @brief Largest key with the given timestamp. */
+    static UUID7Key maxForTimestamp(uint64_t ms) noexcept {
+        return UUID7Key(((ms & 0x0000FFFFFFFFFFFFULL) << 16) | 0xFFFF,
+                        ~0ULL);
+    }
+
+    /** @brief Three-way compare (-1, 0, 1) without branches. */
+    static int compare(const UUID7Key &a, const UUID7Key &b) noexcept {
+        int h = (a.hi > b.hi) - (a.hi < b.hi);
+        int l = (a.lo > b.lo) - (a.lo < b.lo);
+        return h != 0 ? h : l;
+    }
+
+    /**
+     * @brief 64-bit hash. v7 keys carry 74 random bits in the low half, so a
+     * multiply-xorshift over both halves spreads them well.
+     */
+    uint64_t hash() const noexcept {
+        uint64_t x = lo ^ (hi * 0x9E3779B97F4A7C15ULL);
+        x ^= x >> 32;
+        x *= 0xD6E8FEB86659FD93ULL;
+        return x ^ (x >> 32);
+    }
+
+    bool operator==(const UUID7Key &o) const noexcept {
+        return ((hi ^ o.hi) | (lo ^ o.lo)) == 0;
+    }
+    bool operator!=(const UUID7Key &o) const noexcept { return !(*this == o); }
+    bool operator<(const UUID7Key &o) const noexcept {
+        return hi < o.hi || (hi == o.hi && lo < o.lo);
+    }
+    bool operator>(const UUID7Key &o) const noexcept { return o < *this; }
+    bool operator<=(const UUID7Key &o) const noexcept { return !(o < *this); }
+    bool operator>=(const UUID7Key &o) const noexcept { return !(*this < o); }
+};
+
+#if !defined(ARDUINO)
+namespace std {
+template <> struct hash<UUID7Key> {
+    size_t operator()(const UUID7Key &k) const noexcept {
+        return (size_t)k.hash();
+    }
+};
+} // namespace std
+#endif
@@ -4,15 +4,160 @@
 
 #pragma once
 #include "UUID7Types.h"
+#include "UUID7Atomic.h"
 
 struct UUID7PersistenceState {
     uuid7::uuid_load_fn load;
     uuid7::uuid_save_fn save;
     void *ctx;
     uint32_t interval_ms;
+    // Periodic mode: last saved (or published) timestamp.
+    // Lease mode: end of the current lease.
     uint64_t last_saved_ms;
+    bool deferred;
+    // Lease mode (lease_ms != 0): the stored value is the end of a reserved
+    // window, renewed margin_ms before it runs out.
+    uint32_t lease_ms;
+    uint32_t margin_ms;
+    // Deferred mode: latest published value and the last value actually
+    // written; the state is dirty while pending_ms > flushed_ms.
+    // Accessed atomically where UUID7_HAS_ATOMIC64 is available, under
+    // UUID7Guard otherwise.
+    uint64_t pending_ms;
+    uint64_t flushed_ms;
 
     UUID7PersistenceState() noexcept
         : load(nullptr), save(nullptr), ctx(nullptr),
-          interval_ms(10000), last_saved_ms(0) {}
+          interval_ms(10000), last_saved_ms(0), deferred(false),
+          lease_ms(0), margin_ms(0), pending_ms(0), flushed_ms(0) {}
+
+    /** @brief Timestamp that load() resumes from for a stored value. */
+    uint64_t resumeFrom(uint64_t saved_ts) const noexcept {
+        return lease_ms ? saved_ts + 1 : saved_ts + interval_ms;
+    }
+
+    /**
+     * @brief Check whether a save is due for the given timestamp and, if so,
+     * record the new high-water mark (periodic) or lease end. Caller must
+     * hold UUID7Guard.
+     * In deferred mode the value is only published for flushStorage(); an
+     * inline save is requested solely if the last write no longer covers
+     * now_ms, which keeps load()'s safety jump valid.
+     * @return Value the caller must save() after releasing the lock, or 0.
+     */
+    uint64_t claim(uint64_t now_ms) noexcept {
+        if (!save)
+            return 0;
+        bool renew;
+        if (lease_ms) {
+            renew = now_ms + margin_ms >= last_saved_ms;
+            if (renew)
+                last_saved_ms = now_ms + lease_ms;
+        } else {
+            renew = now_ms > last_saved_ms + (deferred ? 0 : interval_ms);
+            if (renew)
+                last_saved_ms = now_ms;
+        }
+        if (!deferred)
+            return renew ? last_saved_ms : 0;
+        if (renew)
+            publish(last_saved_ms);
+        return overdue(now_ms, last_saved_ms) ? last_saved_ms : 0;
+    }
+
+#if defined(UUID7_HAS_ATOMIC64)
+    /** @brief Lock-free variant of claim() for the lock-free generator mode. */
+    uint64_t claimAtomic(uint64_t now_ms) noexcept {
+        if (!save)
+            return 0;
+        uint64_t last = uuid7::atomic::loadRelaxed(&last_saved_ms);
+        uint64_t next = last;
+        while (true) {
+            bool renew = lease_ms ? now_ms + margin_ms >= last
+                                  : now_ms > last + (deferred ? 0 : interval_ms);
+            if (!renew) {
+                next = last;
+                break;
+            }
+            next = lease_ms ? now_ms + lease_ms : now_ms;
+            if (uuid7::atomic::cas(&last_saved_ms, last, next)) {
+                if (!deferred)
+                    return next;
+                publish(next);
+                break;
+            }
+        }
+        if (!deferred)
+            return 0;
+        return overdue(now_ms, next) ? next : 0;
+    }
+
+    /** @brief Raise the pending value to v. */
+    void publish(uint64_t v) noexcept {
+        uint64_t cur = uuid7::atomic::loadRelaxed(&pending_ms);
+        while (v > cur && !uuid7::atomic::cas(&pending_ms, cur, v)) {
+        }
+    }
+
+    /**
+     * @brief Pending value to write, or 0 if it is not more than min_gap_ms
+     * ahead of the last write.
+     */
+    uint64_t due(uint64_t min_gap_ms) const noexcept {
+        uint64_t pending = uuid7::atomic::load(&pending_ms);
+        uint64_t flushed = uuid7::atomic::load(&flushed_ms);
+        return pending > flushed + min_gap_ms ? pending : 0;
+    }
+
+    /** @brief Record a completed write of v. */
+    void markFlushed(uint64_t v) noexcept {
+        uint64_t cur = uuid7::atomic::loadRelaxed(&flushed_ms);
+        while (v > cur && !uuid7::atomic::cas(&flushed_ms, cur, v)) {
+        }
+    }
+
+    /**
+     * @brief Deferred mode fallback: true (once) if the last write no longer
+     * covers now_ms, in which case the caller saves v inline.
+     */
+    bool overdue(uint64_t now_ms, uint64_t v) noexcept {
+        uint64_t cur = uuid7::atomic::load(&flushed_ms);
+        while (!covers(cur, now_ms)) {
+            if (uuid7::atomic::cas(&flushed_ms, cur, v))
+                return true;
+        }
+        return false;
+    }
+#else
+    // Caller holds UUID7Guard.
+    void publish(uint64_t v) noexcept {
+        if (v > pending_ms)
+            pending_ms = v;
+    }
+
+    uint64_t due(uint64_t min_gap_ms) const noexcept {
+        return pending_ms > flushed_ms + min_gap_ms ? pending_ms : 0;
+    }
+
+    void markFlushed(uint64_t v) noexcept {
+        if (v > flushed_ms)
+            flushed_ms = v;
+    }
+
+    bool overdue(uint64_t now_ms, uint64_t v) noexcept {
+        if (covers(flushed_ms, now_ms))
+            return false;
+        flushed_ms = v;
+        return true;
+    }
+#endif
+
+    /** @brief Whether a stored value still protects IDs stamped now_ms. */
+    bool covers(uint64_t stored, uint64_t now_ms) const noexcept {
+        return lease_ms ? now_ms + margin_ms < stored
+                        : now_ms <= stored + interval_ms;
+    }
+
+    /** @brief Minimum lead of a pending value before flushStorage() writes. */
+    uint64_t flushGap() const noexcept { return lease_ms ? 0 : interval_ms / 2; }
 };
@@ -0,0 +1,303 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2026 bkwoka
+// Repository: https://github.com/bkwoka/UUIDv7
+
+#pragma once
+
+#include "UUID7.h"
+#include <string.h>
+
+#if defined(PLATFORMIO_ESP32) || defined(ARDUINO_ARCH_ESP32)
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#define UUID7_PREFETCH_TASK
+#elif defined(PLATFORMIO_NATIVE) && !defined(ARDUINO)
+#include <chrono>
+#include <thread>
+#define UUID7_PREFETCH_TASK
+#endif
+
+/**
+ * @class UUID7Prefetcher
+ * @brief Ring of ready IDs filled ahead of time by a producer on another core.
+ *
+ * The producer is the only caller of the wrapped generator: it runs
+ * generateBatch() into the free slots of a single-producer/single-consumer
+ * ring whenever the fill level drops to the low watermark, so RNG, clock,
+ * UUID7Guard and persistence saves all happen on its core. pop() is two
+ * index loads, a 16-byte copy and an index store.
+ *
+ * Monotonicity and the persistence high-water mark are those of the
+ * generator, because IDs leave the ring in the order it issued them and the
+ * mark is saved when they are generated, before anyone consumes them. IDs
+ * still queued at reset are discarded, never reissued. Timestamps record
+ * generation time, so they trail pop() by at most the time the ring takes
+ * to drain; keep Depth small where that matters.
+ *
+ * @code
+ * UUID7 uuid;
+ * UUID7Prefetcher<32> ids(uuid);
+ * void setup() { ids.start(0); }     // ESP32: producer pinned to core 0
+ * void handler() {
+ *   uint8_t id[16];
+ *   if (ids.pop(id)) { ... }
+ * }
+ * @endcode
+ * On RP2040 (arduino-pico), call ids.service() from loop1() instead.
+ *
+ * @tparam Depth Ring capacity in IDs (power of two, 16 bytes each).
+ * @note Single consumer: calls to pop() / popFromISR() must not overlap. Use
+ *       one prefetcher per consumer, or pop under a lock. Do not call the
+ *       generator directly while the producer runs. On ESP32, pop() wakes
+ *       the producer with xTaskNotifyGive() and must not be called from an
+ *       ISR; use popFromISR() there.
+ */
+template <size_t Depth = 32> class UUID7Prefetcher {
+  static_assert(Depth >= 2 && (Depth & (Depth - 1)) == 0,
+                "UUID7Prefetcher depth must be a power of two");
+
+public:
+  /**
+   * @param gen Generator owned by the producer from now on.
+   * @param low_watermark Refill once at most this many IDs are left
+   *        (clamped to Depth - 1; default: half the ring).
+   */
+  explicit UUID7Prefetcher(UUID7 &gen, size_t low_watermark = Depth / 2) noexcept
+      : _gen(gen), _head(0), _tail(0), _misses(0),
+        _low(low_watermark < Depth ? (uint32_t)low_watermark : (uint32_t)Depth - 1) {
+#if defined(UUID7_PREFETCH_TASK)
+    _stop = 0;
+    _running = 0;
+#endif
+  }
+
+  ~UUID7Prefetcher() {
+#if defined(UUID7_PREFETCH_TASK)
+    stop();
+#endif
+  }
+
+  UUID7Prefetcher(const UUID7Prefetcher &) = delete;
+  UUID7Prefetcher &operator=(const UUID7Prefetcher &) = delete;
+
+  /**
+   * @brief Take the oldest ready ID (consumer side).
+   * @return false if the ring is empty (counted in misses()).
+   */
+  UUID7_NODISCARD bool pop(uint8_t out[16]) noexcept {
+    bool wake;
+    bool ok = _take(out, wake);
+    if (wake)
+      _wake();
+    return ok;
+  }
+
+  UUID7_NODISCARD bool pop(uuid7::Id &out) noexcept { return pop(out.b); }
+
+  /**
+   * @brief pop() for interrupt handlers: the producer is woken with
+   * vTaskNotifyGiveFromISR() and a context switch is requested on exit if
+   * it outranks the interrupted task. Same as pop() without a producer task.
+   */
+  UUID7_NODISCARD bool popFromISR(uint8_t out[16]) noexcept {
+    bool wake;
+    bool ok = _take(out, wake);
+    if (wake)
+      _wakeFromISR();
+    return ok;
+  }
+
+  UUID7_NODISCARD bool popFromISR(uuid7::Id &out) noexcept { return popFromISR(out.b); }
+
+  /**
+   * @brief Producer step: if the fill level is at or below the low
+   * watermark, top the ring up. Call from the producer core's loop (e.g.
+   * loop1() on RP2040); start() does this in a task.
+   * @return Number of IDs added (0 if above the watermark or on failure).
+   */
+  size_t service() noexcept {
+    if (size() > __atomic_load_n(&_low, __ATOMIC_RELAXED))
+      return 0;
+    return fill();
+  }
+
+  /**
+   * @brief Producer step: fill every free slot now. Also used from setup()
+   * to prime the ring before the consumer starts.
+   * @return Number of IDs added; fewer than the free slots only on RNG or
+   *         clock failure or a FAIL_FAST counter overflow.
+   */
+  size_t fill() noexcept {
+    uint32_t head = __atomic_load_n(&_head, __ATOMIC_RELAXED);
+    size_t done = 0;
+    while (true) {
+      uint32_t tail = __atomic_load_n(&_tail, __ATOMIC_ACQUIRE);
+      size_t free_slots = Depth - (size_t)(head - tail);
+      if (free_slots == 0)
+        break;
+      // Contiguous run up to the end of the array, then wrap.
+      size_t at = head & (Depth - 1);
+      size_t run = Depth - at < free_slots ? Depth - at : free_slots;
+      size_t got = _gen.generateBatch(_ring + at, run);
+      head += (uint32_t)got;
+      __atomic_store_n(&_head, head, __ATOMIC_RELEASE);
+      done += got;
+      if (got < run)
+        break;
+    }
+    return done;
+  }
+
+  /** @brief IDs ready to pop. */
+  size_t size() const noexcept {
+    uint32_t head = __atomic_load_n(&_head, __ATOMIC_ACQUIRE);
+    return (size_t)(head - __atomic_load_n(&_tail, __ATOMIC_ACQUIRE));
+  }
+
+  bool empty() const noexcept { return size() == 0; }
+
+  static constexpr size_t capacity() { return Depth; }
+
+  size_t lowWatermark() const noexcept { return _low; }
+
+  /** @brief Set the refill threshold (clamped to Depth - 1). */
+  void setLowWatermark(size_t n) noexcept {
+    __atomic_store_n(&_low, n < Depth ? (uint32_t)n : (uint32_t)Depth - 1,
+                     __ATOMIC_RELAXED);
+  }
+
+  /** @brief pop() calls that found the ring empty. */
+  uint32_t misses() const noexcept { return __atomic_load_n(&_misses, __ATOMIC_RELAXED); }
+
+#if defined(UUID7_PREFETCH_TASK)
+#if defined(PLATFORMIO_ESP32) || defined(ARDUINO_ARCH_ESP32)
+  /**
+   * @brief Prime the ring and start the producer task pinned to a core.
+   * The task sleeps until pop() crosses the low watermark (or one tick).
+   * @return false if already running or the task could not be created.
+   */
+  bool start(BaseType_t core = 0, uint32_t stack_bytes = 4096,
+             UBaseType_t priority = 1) noexcept {
+    if (!_claim())
+      return false;
+    fill();
+    __atomic_store_n(&_stop, 0, __ATOMIC_RELEASE);
+    // The task publishes its own handle, so _task never outlives it.
+    if (xTaskCreatePinnedToCore(&UUID7Prefetcher::_run, "uuid7_prefetch", stack_bytes,
+                                this, priority, nullptr, core) != pdPASS) {
+      __atomic_store_n(&_running, 0, __ATOMIC_RELEASE);
+      return false;
+    }
+    return true;
+  }
+
+  /**
+   * @brief Stop the producer task and wait for it to exit.
+   * @note Call while no pop() is in progress.
+   */
+  void stop() noexcept {
+    if (!__atomic_load_n(&_running, __ATOMIC_ACQUIRE))
+      return;
+    // The task notices within one tick (its notify wait times out).
+    __atomic_store_n(&_stop, 1, __ATOMIC_RELEASE);
+    while (__atomic_load_n(&_running, __ATOMIC_ACQUIRE))
+      vTaskDelay(1);
+  }
+#else
+  /** @brief Prime the ring and start the producer thread. */
+  bool start() {
+    if (!_claim())
+      return false;
+    fill();
+    __atomic_store_n(&_stop, 0, __ATOMIC_RELEASE);
+    _thread = std::thread([this]() {
+      while (!__atomic_load_n(&_stop, __ATOMIC_ACQUIRE)) {
+        if (!service())
+          std::this_thread::sleep_for(std::chrono::microseconds(50));
+      }
+    });
+    return true;
+  }
+
+  /** @brief Stop the producer thread and join it. */
+  void stop() {
+    if (!_thread.joinable())
+      return;
+    __atomic_store_n(&_stop, 1, __ATOMIC_RELEASE);
+    _thread.join();
+    __atomic_store_n(&_running, 0, __ATOMIC_RELEASE);
+  }
+#endif
+#endif
+
+private:
+  UUID7 &_gen;
+  uint8_t _ring[Depth][16];
+  uint32_t _head; // Written by the producer only
+  uint32_t _tail; // Written by the consumer only
+  uint32_t _misses;
+  uint32_t _low;
+#if defined(UUID7_PREFETCH_TASK)
+  uint32_t _stop;
+  uint32_t _running; // Claimed by start() with a CAS, so a second start() fails
+
+  bool _claim() noexcept {
+    uint32_t idle = 0;
+    return __atomic_compare_exchange_n(&_running, &idle, 1, false, __ATOMIC_ACQ_REL,
+                                       __ATOMIC_RELAXED);
+  }
+#endif
+
+  /** @brief Consumer step shared by pop() and popFromISR(). */
+  bool _take(uint8_t out[16], bool &wake) noexcept {
+    uint32_t tail = __atomic_load_n(&_tail, __ATOMIC_RELAXED);
+    uint32_t head = __atomic_load_n(&_head, __ATOMIC_ACQUIRE);
+    if (head == tail) {
+      __atomic_store_n(&_misses, _misses + 1, __ATOMIC_RELAXED);
+      wake = true;
+      return false;
+    }
+    memcpy(out, _ring[tail & (Depth - 1)], 16);
+    __atomic_store_n(&_tail, tail + 1, __ATOMIC_RELEASE);
+    wake = head - tail - 1 == __atomic_load_n(&_low, __ATOMIC_RELAXED);
+    return true;
+  }
+
+#if defined(PLATFORMIO_ESP32) || defined(ARDUINO_ARCH_ESP32)
+  TaskHandle_t _task = nullptr; // Set and cleared by the task itself
+
+  static void _run(void *arg) {
+    UUID7Prefetcher *self = static_cast<UUID7Prefetcher *>(arg);
+    __atomic_store_n(&self->_task, xTaskGetCurrentTaskHandle(), __ATOMIC_RELEASE);
+    while (!__atomic_load_n(&self->_stop, __ATOMIC_ACQUIRE)) {
+      if (!self->service())
+        ulTaskNotifyTake(pdTRUE, 1);
+    }
+    __atomic_store_n(&self->_task, (TaskHandle_t) nullptr, __ATOMIC_RELEASE);
+    __atomic_store_n(&self->_running, 0, __ATOMIC_RELEASE);
+    vTaskDelete(nullptr);
+  }
+
+  void _wake() noexcept {
+    TaskHandle_t h = __atomic_load_n(&_task, __ATOMIC_ACQUIRE);
+    if (h)
+      xTaskNotifyGive(h);
+  }
+
+  void _wakeFromISR() noexcept {
+    TaskHandle_t h = __atomic_load_n(&_task, __ATOMIC_ACQUIRE);
+    if (!h)
+      return;
+    BaseType_t woken = pdFALSE;
+    vTaskNotifyGiveFromISR(h, &woken);
+    if (woken)
+      portYIELD_FROM_ISR();
+  }
+#else
+#if defined(UUID7_PREFETCH_TASK)
+  std::thread _thread;
+#endif
+  void _wake() noexcept {}
+  void _wakeFromISR() noexcept {}
+#endif
+};
@@ -4,9 +4,10 @@
 
 #pragma once
 
-#if defined(ARDUINO_ARCH_AVR) || defined(__AVR__)
 #include <stdint.h>
 
+#if defined(ARDUINO_ARCH_AVR) || defined(__AVR__)
+
 static inline uint32_t uuid_mix32(uint32_t k) {
   k ^= k >> 16;
   k *= 0x85ebca6b;
@@ -25,3 +26,46 @@ static inline uint32_t uuid_xorshift32(uint32_t *state) {
   return x;
 }
 #endif
+
+static inline uint32_t uuid_rotl32(uint32_t v, int c) {
+  return (v << c) | (v >> (32 - c));
+}
+
+static inline void uuid_chacha_qr(uint32_t *x, int a, int b, int c, int d) {
+  x[a] += x[b]; x[d] = uuid_rotl32(x[d] ^ x[a], 16);
+  x[c] += x[d]; x[b] = uuid_rotl32(x[b] ^ x[c], 12);
+  x[a] += x[b]; x[d] = uuid_rotl32(x[d] ^ x[a], 8);
+  x[c] += x[d]; x[b] = uuid_rotl32(x[b] ^ x[c], 7);
+}
+
+/**
+ * @brief ChaCha20 block function (RFC 8439 rounds) with a 64-bit block
+ * counter in words 12-13 and a zero nonce. Writes 64 keystream bytes.
+ */
+static inline void uuid_chacha20_block(const uint32_t key[8], uint64_t counter,
+                                       uint8_t out[64]) {
+  uint32_t s[16] = {0x61707865, 0x3320646e, 0x79622d32, 0x6b206574,
+                    key[0], key[1], key[2], key[3],
+                    key[4], key[5], key[6], key[7],
+                    (uint32_t)counter, (uint32_t)(counter >> 32), 0, 0};
+  uint32_t x[16];
+  for (int i = 0; i < 16; i++)
+    x[i] = s[i];
+  for (int i = 0; i < 10; i++) {
+    uuid_chacha_qr(x, 0, 4, 8, 12);
+    uuid_chacha_qr(x, 1, 5, 9, 13);
+    uuid_chacha_qr(x, 2, 6, 10, 14);
+    uuid_chacha_qr(x, 3, 7, 11, 15);
+    uuid_chacha_qr(x, 0, 5, 10, 15);
+    uuid_chacha_qr(x, 1, 6, 11, 12);
+    uuid_chacha_qr(x, 2, 7, 8, 13);
+    uuid_chacha_qr(x, 3, 4, 9, 14);
+  }
+  for (int i = 0; i < 16; i++) {
+    uint32_t v = x[i] + s[i];
+    out[i * 4 + 0] = (uint8_t)v;
+    out[i * 4 + 1] = (uint8_t)(v >> 8);
+    out[i * 4 + 2] = (uint8_t)(v >> 16);
+    out[i * 4 + 3] = (uint8_t)(v >> 24);
+  }
+}
@@ -0,0 +1,87 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2026 bkwoka
+// Repository: https://github.com/bkwoka/UUIDv7
+
+#pragma once
+
+#include "UUID7Counter.h"
+#include <stddef.h>
+#include <string.h>
+
+class UUID7;
+
+/**
+ * @class UUID7Range
+ * @brief A block of consecutive v7 IDs reserved with UUID7::reserve().
+ *
+ * All IDs share one timestamp and consecutive counter values c..c+N-1, so
+ * they sort in index order and after every ID issued before the reservation.
+ * The bytes are only materialized when an element is read, without touching
+ * the generator again.
+ *
+ * @code
+ * UUID7Range rows;
+ * if (uuid.reserve(500, rows)) {
+ *   for (const uint8_t *id : rows) insert_row(id);
+ * }
+ * @endcode
+ */
+class UUID7Range {
+public:
+  UUID7Range() noexcept : _n(0) { memset(_first, 0, sizeof(_first)); }
+
+  /** @brief Number of reserved IDs. */
+  size_t size() const noexcept { return _n; }
+
+  /** @brief Check if the range holds no IDs. */
+  bool empty() const noexcept { return _n == 0; }
+
+  /**
+   * @brief Write the i-th reserved ID.
+   * @return false if i is out of range.
+   */
+  bool get(size_t i, uint8_t out[16]) const noexcept {
+    if (i >= _n)
+      return false;
+    memcpy(out, _first, 16);
+    if (i) {
+      UUID7Counter c = _ctr;
+      c.add((uint32_t)i);
+      c.store(out);
+    }
+    return true;
+  }
+
+  /** @brief Forward iterator yielding a pointer to each ID's 16 bytes. */
+  class iterator {
+  public:
+    iterator(const UUID7Range *r, size_t i) noexcept : _r(r), _i(i) {}
+
+    /** @brief Materializes the current ID; valid until the next dereference. */
+    const uint8_t *operator*() noexcept {
+      _r->get(_i, _buf);
+      return _buf;
+    }
+    iterator &operator++() noexcept {
+      _i++;
+      return *this;
+    }
+    bool operator==(const iterator &o) const noexcept { return _i == o._i; }
+    bool operator!=(const iterator &o) const noexcept { return _i != o._i; }
+
+  private:
+    const UUID7Range *_r;
+    size_t _i;
+    uint8_t _buf[16];
+  };
+
+  iterator begin() const noexcept { return iterator(this, 0); }
+  iterator end() const noexcept { return iterator(this, _n); }
+
+private:
+  friend class UUID7;
+
+  uint8_t _first[16]; // First ID, fully stamped
+  UUID7Counter _ctr;  // Counter value of the first ID
+  size_t _n;
+};
@@ -17,6 +17,112 @@ extern "C" {
 #include <hardware/structs/rosc.h>
 #elif defined(PLATFORMIO_NATIVE)
 #include <random>
+#if defined(__APPLE__) || defined(__FreeBSD__) || defined(__OpenBSD__) ||      \
+    defined(__NetBSD__)
+#include <stdlib.h>
+#define UUID7_NATIVE_ARC4RANDOM
+#elif defined(__linux__)
+#include <errno.h>
+#include <sys/random.h>
+#define UUID7_NATIVE_GETRANDOM
+#endif
+#if defined(__unix__) || defined(__APPLE__)
+#include <pthread.h>
+#endif
+#endif
+
+#if defined(PLATFORMIO_NATIVE)
+void UUID7::os_fill_random(uint8_t *dest, size_t len, void *ctx) noexcept {
+  (void)ctx;
+#if defined(UUID7_NATIVE_ARC4RANDOM)
+  arc4random_buf(dest, len);
+#else
+#if defined(UUID7_NATIVE_GETRANDOM)
+  while (len > 0) {
+    ssize_t r = getrandom(dest, len, 0);
+    if (r < 0) {
+      if (errno == EINTR)
+        continue;
+      break; // ENOSYS on old kernels: fall through to std::random_device
+    }
+    dest += r;
+    len -= (size_t)r;
+  }
+#endif
+  if (len > 0) {
+    static std::mutex s_rd_mutex;
+    std::lock_guard<std::mutex> lock(s_rd_mutex);
+    static std::random_device rd;
+    while (len > 0) {
+      uint32_t w = rd();
+      size_t n = len < 4 ? len : 4;
+      memcpy(dest, &w, n);
+      dest += n;
+      len -= n;
+    }
+  }
+#endif
+}
+
+#if !defined(UUID7_NATIVE_RNG_OS)
+// Per-thread ChaCha20 expander keyed from the OS CSPRNG: no shared state on
+// the hot path, one keystream block per 4 UUIDs, rekeyed every 1 MiB.
+struct UUIDNativeRng {
+  uint32_t key[8];
+  uint64_t counter;
+  uint32_t blocks_left;
+  unsigned fork_gen;
+  uint8_t pos;
+  uint8_t buf[64];
+};
+
+// Bumped in the child after fork() so that both processes never continue
+// the same keystream.
+static unsigned s_uuid_fork_gen = 0;
+#if defined(__unix__) || defined(__APPLE__)
+static void uuid_native_on_fork() {
+  __atomic_add_fetch(&s_uuid_fork_gen, 1, __ATOMIC_RELAXED);
+}
+static const int s_uuid_atfork =
+    pthread_atfork(nullptr, nullptr, &uuid_native_on_fork);
+#endif
+
+static void uuid_native_rekey(UUIDNativeRng &r) {
+  uint8_t seed[32];
+  UUID7::os_fill_random(seed, sizeof(seed), nullptr);
+  memcpy(r.key, seed, sizeof(seed));
+  memset(seed, 0, sizeof(seed));
+  r.counter = 0;
+  r.blocks_left = (1u << 20) / 64;
+  r.fork_gen = __atomic_load_n(&s_uuid_fork_gen, __ATOMIC_RELAXED);
+}
+
+static void uuid_native_fill(uint8_t *dest, size_t len) {
+  static thread_local UUIDNativeRng t_rng = {{0}, 0, 0, 0, 64, {0}};
+  UUIDNativeRng &r = t_rng;
+  if (r.fork_gen != __atomic_load_n(&s_uuid_fork_gen, __ATOMIC_RELAXED)) {
+    r.blocks_left = 0;
+    r.pos = 64;
+  }
+  while (len > 0) {
+    if (r.pos == 64) {
+      if (r.blocks_left == 0)
+        uuid_native_rekey(r);
+      uuid_chacha20_block(r.key, r.counter++, r.buf);
+      r.blocks_left--;
+      r.pos = 0;
+    }
+    size_t n = 64 - r.pos;
+    if (n > len)
+      n = len;
+    memcpy(dest, r.buf + r.pos, n);
+    memset(r.buf + r.pos, 0, n); // Never hand out the same bytes twice
+    r.pos += (uint8_t)n;
+    dest += n;
+    len -= n;
+  }
+}
+#endif
 #endif
 
 void UUID7::default_fill_random(uint8_t *dest, size_t len, void *ctx) noexcept {
@@ -153,13 +259,12 @@ void UUID7::default_fill_random(uint8_t *dest, size_t len, void *ctx) noexcept {
   }
 
 #elif defined(PLATFORMIO_NATIVE)
+#if defined(UUID7_NATIVE_RNG_OS)
+  os_fill_random(dest, len, ctx);
+#else
   (void)ctx;
-  static std::random_device rd;
-  static std::mt19937_64 eng(rd());
-  static std::uniform_int_distribution<uint8_t> dist(0, 255);
-  for (size_t k = 0; k < len; k++) {
-    dest[k] = dist(eng);
-  }
+  uuid_native_fill(dest, len);
+#endif
 #else
   (void)ctx;
 #ifdef ARDUINO
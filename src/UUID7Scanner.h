@@ -0,0 +1,294 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2026 bkwoka
+// Repository: https://github.com/bkwoka/UUIDv7
+
+#pragma once
+#include "UUID7Codec.h"
+#include "UUID7Id.h"
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+// 16-byte hex classification. SSE2 is part of the x86-64 baseline; AArch64
+// uses the NEON path UUID7Codec already enables.
+#if !defined(UUID7_OPTIMIZE_SIZE) && !defined(UUID7_NO_SIMD)
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define UUID7_SCANNER_SSE2
+#elif defined(UUID7_CODEC_NEON)
+#define UUID7_SCANNER_NEON
+#endif
+#endif
+
+/**
+ * @class UUID7Scanner
+ * @brief Finds UUIDs in place inside text buffers or chunked streams.
+ *
+ * Recognizes the 36-character dashed and the 32-character plain forms (either
+ * case) delimited by non-hex characters, so "id":"0190...", CSV fields and
+ * log lines all match while longer hex runs do not. Nothing is copied except
+ * a candidate that straddles a chunk boundary (at most 36 bytes, carried
+ * into the next feed()). Offsets count from the first byte ever fed.
+ *
+ * @code
+ * UUID7Scanner scan;
+ * UUID7Scanner::Match m;
+ * while (size_t n = read(fd, buf, sizeof(buf))) {
+ *     scan.feed(buf, n);
+ *     while (scan.next(m)) handle(m.id, m.offset);
+ * }
+ * scan.finish();
+ * while (scan.next(m)) handle(m.id, m.offset);
+ * @endcode
+ */
+class UUID7Scanner {
+public:
+    /** Forms to recognize (bitmask). */
+    enum Forms { DASHED = 1, UNDASHED = 2, ANY = 3 };
+
+    struct Match {
+        uuid7::Id id;    // Decoded bytes
+        uint64_t offset; // Stream offset of the first character
+        uint8_t length;  // 36 (dashed) or 32 (plain)
+    };
+
+    explicit UUID7Scanner(unsigned forms = ANY) noexcept : _forms(forms) { reset(); }
+
+    /** @brief Forget all stream state (offsets restart at 0). */
+    void reset() noexcept {
+        _buf = nullptr;
+        _len = 0;
+        _pos = 0;
+        _base = 0;
+        _fed = 0;
+        _carryLen = 0;
+        _carryOffset = 0;
+        _seamLen = 0;
+        _seamFinal = false;
+        _final = false;
+        _prevHex = false;
+        _phase = IDLE;
+    }
+
+    /**
+     * @brief Hand the scanner the next chunk. The buffer must stay valid
+     * until next() returns false; drain next() before feeding again.
+     * @param last true if no more data follows (same as a later finish()).
+     */
+    void feed(const char *buf, size_t len, bool last = false) noexcept {
+        _buf = buf;
+        _len = buf ? len : 0;
+        _base = _fed;
+        _fed += _len;
+        _final = last;
+        _pos = 0;
+        if (_carryLen) {
+            size_t take = _len < (size_t)SEAM_LOOKAHEAD ? _len : (size_t)SEAM_LOOKAHEAD;
+            memcpy(_seam, _carry, _carryLen);
+            if (take)
+                memcpy(_seam + _carryLen, _buf, take);
+            _seamLen = _carryLen + take;
+            _seamFinal = last && take == _len;
+            _phase = SEAM;
+        } else {
+            _phase = CHUNK;
+        }
+    }
+
+    /** @brief Mark the end of the stream, resolving a carried candidate. */
+    void finish() noexcept { feed(nullptr, 0, true); }
+
+    /** @brief Next UUID in the current chunk. @return false when drained. */
+    bool next(Match &out) noexcept {
+        size_t at;
+        uint8_t len;
+        while (true) {
+            if (_phase == SEAM) {
+                Step st = scanIn(_seam, _seamLen, _carryLen, _seamFinal, at, len);
+                if (st == FOUND)
+                    return emit(_seam + at, _carryOffset + at, len, out);
+                if (st == NEED_MORE) {
+                    // The seam held the whole chunk; carry the candidate on.
+                    _carryOffset += _pos;
+                    _carryLen = _seamLen - _pos;
+                    memmove(_carry, _seam + _pos, _carryLen);
+                    _prevHex = false;
+                    _phase = IDLE;
+                    return false;
+                }
+                _prevHex = isHex(_seam[_carryLen - 1]);
+                _pos -= _carryLen;
+                _carryLen = 0;
+                _phase = CHUNK;
+            } else if (_phase == CHUNK) {
+                Step st = scanIn(_buf, _len, _len, _final, at, len);
+                if (st == FOUND)
+                    return emit(_buf + at, _base + at, len, out);
+                if (st == NEED_MORE) {
+                    _carryOffset = _base + _pos;
+                    _carryLen = _len - _pos;
+                    memcpy(_carry, _buf + _pos, _carryLen);
+                    _prevHex = false;
+                } else if (_len) {
+                    _prevHex = isHex(_buf[_len - 1]);
+                }
+                _phase = IDLE;
+                return false;
+            } else {
+                return false;
+            }
+        }
+    }
+
+    /**
+     * @brief One-shot scan of a complete buffer.
+     * @return Number of matches written to out (at most max_out).
+     */
+    static size_t scan(const char *buf, size_t len, Match *out, size_t max_out,
+                       unsigned forms = ANY) noexcept {
+        UUID7Scanner s(forms);
+        s.feed(buf, len, true);
+        size_t n = 0;
+        while (n < max_out && s.next(out[n]))
+            n++;
+        return n;
+    }
+
+    static bool isHex(char c) noexcept {
+        static const uint32_t bits[8] = {0, 0x03FF0000, 0x0000007E, 0x0000007E, 0, 0, 0, 0};
+        uint8_t u = (uint8_t)c;
+        return (bits[u >> 5] >> (u & 31)) & 1;
+    }
+
+private:
+    enum Phase { IDLE, SEAM, CHUNK };
+    enum Step { FOUND, NEED_MORE, END };
+
+    // Bytes of the new chunk appended to a carried candidate: enough to
+    // resolve any candidate that starts inside the carry.
+    enum { SEAM_LOOKAHEAD = 37 };
+
+    /**
+     * @brief Look for the next UUID starting in s[_pos..limit).
+     * @param final s ends the stream (no more bytes after n).
+     * @return FOUND (at/len set, _pos past the match), NEED_MORE (_pos at a
+     *         candidate that needs bytes beyond n), or END (_pos >= limit).
+     */
+    Step scanIn(const char *s, size_t n, size_t limit, bool final, size_t &at,
+                uint8_t &len) noexcept {
+        while (_pos < limit) {
+            size_t p = findHex(s, _pos, limit);
+            if (p == limit) {
+                _pos = limit;
+                break;
+            }
+            size_t run = hexRun(s, p, n);
+            bool prevHex = p ? isHex(s[p - 1]) : _prevHex;
+            _pos = p + run;
+            if (prevHex || run > 32)
+                continue; // Inside a longer hex run
+            if (p + run == n && !final) {
+                _pos = p; // Run may continue in the next chunk
+                return NEED_MORE;
+            }
+            if (run == 32 && (_forms & UNDASHED)) {
+                at = p;
+                len = 32;
+                return FOUND;
+            }
+            if (run == 8 && (_forms & DASHED) && p + 8 < n && s[p + 8] == '-') {
+                if (p + 37 > n && !final) {
+                    _pos = p;
+                    return NEED_MORE;
+                }
+                if (p + 36 <= n && UUID7Codec::isValid(s + p, 36) &&
+                    (p + 36 == n || !isHex(s[p + 36]))) {
+                    at = p;
+                    len = 36;
+                    _pos = p + 36;
+                    return FOUND;
+                }
+            }
+        }
+        return END;
+    }
+
+    static bool emit(const char *s, uint64_t offset, uint8_t len, Match &out) noexcept {
+        out.offset = offset;
+        out.length = len;
+        return UUID7Codec::decode(s, len, out.id.b);
+    }
+
+    /** @brief Bit i set if s[i] is a hex digit (16 bytes). */
+    static uint32_t hexMask16(const char *s) noexcept {
+#if defined(UUID7_SCANNER_SSE2)
+        __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i *>(s));
+        __m128i digit = _mm_and_si128(_mm_cmpgt_epi8(c, _mm_set1_epi8('0' - 1)),
+                                      _mm_cmplt_epi8(c, _mm_set1_epi8('9' + 1)));
+        __m128i l = _mm_or_si128(c, _mm_set1_epi8(0x20)); // Fold 'A'-'F' onto 'a'-'f'
+        __m128i alpha = _mm_and_si128(_mm_cmpgt_epi8(l, _mm_set1_epi8('a' - 1)),
+                                      _mm_cmplt_epi8(l, _mm_set1_epi8('f' + 1)));
+        return (uint32_t)_mm_movemask_epi8(_mm_or_si128(digit, alpha));
+#elif defined(UUID7_SCANNER_NEON)
+        static const uint8_t lanes[16] = {1, 2, 4, 8, 16, 32, 64, 128,
+                                          1, 2, 4, 8, 16, 32, 64, 128};
+        uint8x16_t c = vld1q_u8(reinterpret_cast<const uint8_t *>(s));
+        uint8x16_t digit = vcleq_u8(vsubq_u8(c, vdupq_n_u8('0')), vdupq_n_u8(9));
+        uint8x16_t alpha = vcleq_u8(vsubq_u8(vorrq_u8(c, vdupq_n_u8(0x20)), vdupq_n_u8('a')),
+                                    vdupq_n_u8(5));
+        uint8x16_t bits = vandq_u8(vorrq_u8(digit, alpha), vld1q_u8(lanes));
+        return (uint32_t)vaddv_u8(vget_low_u8(bits)) |
+               ((uint32_t)vaddv_u8(vget_high_u8(bits)) << 8);
+#else
+        uint32_t m = 0;
+        for (int i = 0; i < 16; i++)
+            m |= (uint32_t)isHex(s[i]) << i;
+        return m;
+#endif
+    }
+
+    /** @brief First hex digit in s[from..limit), or limit. */
+    static size_t findHex(const char *s, size_t from, size_t limit) noexcept {
+#if defined(UUID7_SCANNER_SSE2) || defined(UUID7_SCANNER_NEON)
+        for (; from + 16 <= limit; from += 16) {
+            uint32_t m = hexMask16(s + from);
+            if (m)
+                return from + (size_t)__builtin_ctz(m);
+        }
+#endif
+        while (from < limit && !isHex(s[from]))
+            from++;
+        return from;
+    }
+
+    /** @brief Length of the hex run starting at s[from] (bounded by n). */
+    static size_t hexRun(const char *s, size_t from, size_t n) noexcept {
+        size_t p = from;
+#if defined(UUID7_SCANNER_SSE2) || defined(UUID7_SCANNER_NEON)
+        for (; p + 16 <= n; p += 16) {
+            uint32_t m = ~hexMask16(s + p) & 0xFFFF;
+            if (m)
+                return p + (size_t)__builtin_ctz(m) - from;
+        }
+#endif
+        while (p < n && isHex(s[p]))
+            p++;
+        return p - from;
+    }
+
+    unsigned _forms;
+    const char *_buf;
+    size_t _len;
+    size_t _pos;      // Scan position in the seam or the chunk
+    uint64_t _base;   // Stream offset of _buf[0]
+    uint64_t _fed;    // Bytes fed so far
+    char _carry[36];  // Unresolved candidate from the previous chunk
+    size_t _carryLen;
+    uint64_t _carryOffset;
+    char _seam[36 + SEAM_LOOKAHEAD]; // _carry + head of the current chunk
+    size_t _seamLen;
+    bool _seamFinal;
+    bool _final;
+    bool _prevHex;    // Character before the scan region is a hex digit
+    Phase _phase;
+};
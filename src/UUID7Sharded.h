@@ -0,0 +1,223 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2026 bkwoka
+// Repository: https://github.com/bkwoka/UUIDv7
+
+#pragma once
+
+#include "UUID7.h"
+#include "UUID7Guard.h"
+
+namespace uuid7 {
+namespace detail {
+
+// Number of bits needed to encode shard indices 0..n-1.
+constexpr uint8_t shardBits(size_t n, uint8_t bits = 0) {
+  return ((size_t)1 << bits) >= n ? bits : shardBits(n, bits + 1);
+}
+
+} // namespace detail
+} // namespace uuid7
+
+/**
+ * @class UUID7Sharded
+ * @brief Front end handing every thread/core its own UUID7 shard.
+ *
+ * Each shard is a full UUID7 with its own monotonic state and its own lock,
+ * so the hot path only touches shard-local cache lines. The shard index is
+ * stored in the top bits of rand_b (ceil(log2(N)) bits, below the node ID of
+ * setNodeId() if one is set), which keeps IDs unique across shards; the
+ * per-shard counter carries below it, with a carry into the shard bits
+ * handled as a regular counter overflow (UUIDOverflowPolicy applies).
+ *
+ * All shards share a coarse millisecond high-water mark that is written only
+ * when the clock advances past it. A shard whose clock reading lags behind it
+ * (within the regression threshold) follows the mark, so an ID observed by a
+ * thread is never followed, on any shard, by an ID from an earlier millisecond.
+ * Within one millisecond, IDs of different shards are unique but unordered.
+ *
+ * @tparam N Number of shards (1..16384).
+ * @note Persistence is configured per shard via shard(i).setStorage().
+ */
+template <size_t N> class UUID7Sharded {
+  static_assert(N >= 1 && N <= 16384, "UUID7Sharded supports 1..16384 shards");
+
+public:
+  typedef uuid7::fill_random_fn fill_random_fn;
+  typedef uuid7::now_ms_fn now_ms_fn;
+
+  /**
+   * @brief Create N shards sharing the given RNG and time sources.
+   * @note The RNG is called concurrently from all shards and must be
+   *       thread-safe.
+   */
+  UUID7Sharded(fill_random_fn rng = nullptr, void *rng_ctx = nullptr,
+               now_ms_fn now = nullptr, void *now_ctx = nullptr) noexcept
+      : _hwm(0), _now(now), _now_ctx(now_ctx), _regressionThresholdMs(10000) {
+    for (size_t i = 0; i < N; i++) {
+      UUID7 &g = _shards[i].gen;
+      if (rng)
+        g.setRandomSource(rng, rng_ctx);
+      g.setTimeProvider(&UUID7Sharded::_clock, this);
+      g._clockPinned = true;
+#if defined(UUID7_HAS_SPINLOCK)
+      // Replace the process-wide guard with this shard's own lock.
+      g.setLockCallbacks(&UUID7Sharded::_lock, &UUID7Sharded::_unlock,
+                         &_shards[i].lock);
+#endif
+      g._shardBits = uuid7::detail::shardBits(N);
+      g._shardId = (uint16_t)i;
+      g._updatePrefix();
+    }
+  }
+
+  UUID7Sharded(const UUID7Sharded &) = delete;
+  UUID7Sharded &operator=(const UUID7Sharded &) = delete;
+
+  /**
+   * @brief Generate a UUID on the shard of the calling thread/core.
+   * @param out Destination 16-byte array.
+   * @return true if successful (same failure modes as UUID7::generate()).
+   */
+  UUID7_NODISCARD bool generate(uint8_t out[16]) {
+    return _shards[currentShard()].gen.generate(out);
+  }
+
+  /**
+   * @brief Generate a UUID on an explicitly selected shard.
+   * @param shard Shard index (taken modulo N).
+   * @param out Destination 16-byte array.
+   */
+  UUID7_NODISCARD bool generate(size_t shard, uint8_t out[16]) {
+    return _shards[shard % N].gen.generate(out);
+  }
+
+  /** @brief Generate a UUID on the calling shard into a uuid7::Id. */
+  UUID7_NODISCARD bool generate(uuid7::Id &out) { return generate(out.b); }
+
+  /** @brief Generate a UUID on the calling shard by value (nil on failure). */
+  UUID7_NODISCARD uuid7::Id generateId() {
+    return _shards[currentShard()].gen.generateId();
+  }
+
+  /**
+   * @brief Set the clock all shards read before the shared high-water mark
+   * is applied (nullptr for UUID7::default_now_ms). Configure before
+   * generating; shard(i).setTimeProvider() is ignored.
+   */
+  void setTimeProvider(now_ms_fn now, void *ctx = nullptr) {
+    _now = now;
+    _now_ctx = ctx;
+  }
+
+  /** @brief Apply an overflow policy to all shards. */
+  void setOverflowPolicy(UUIDOverflowPolicy policy) {
+    for (size_t i = 0; i < N; i++)
+      _shards[i].gen.setOverflowPolicy(policy);
+  }
+
+  /** @brief Apply an entropy mode to all shards. */
+  void setEntropyMode(UUIDEntropyMode mode) {
+    for (size_t i = 0; i < N; i++)
+      _shards[i].gen.setEntropyMode(mode);
+  }
+
+  /** @brief Apply a clock regression threshold to all shards. */
+  void setRegressionThreshold(uint32_t ms) {
+    _regressionThresholdMs = ms;
+    for (size_t i = 0; i < N; i++)
+      _shards[i].gen.setRegressionThreshold(ms);
+  }
+
+  /** @brief Mix additional entropy into all shards (see UUID7::mixEntropy). */
+  void mixEntropy(uint64_t seed) noexcept {
+    for (size_t i = 0; i < N; i++)
+      _shards[i].gen.mixEntropy(seed);
+  }
+
+  /**
+   * @brief Set the node ID on all shards (see UUID7::setNodeId()). It sits
+   * above the shard index; both together may use up to 28 bits.
+   */
+  bool setNodeId(uint32_t id, uint8_t bits) {
+    for (size_t i = 0; i < N; i++)
+      if (!_shards[i].gen.setNodeId(id, bits))
+        return false;
+    return true;
+  }
+
+  /**
+   * @brief Direct access to a shard for advanced configuration. Its time
+   * providers are owned by the front end (see setTimeProvider()).
+   */
+  UUID7 &shard(size_t i) { return _shards[i % N].gen; }
+
+  /** @brief Number of shards. */
+  static constexpr size_t shardCount() { return N; }
+
+  /**
+   * @brief Shard index of the calling context.
+   * Core ID on ESP32/RP2040, a round-robin per-thread slot on native, 0 on
+   * single-core targets.
+   */
+  static size_t currentShard() noexcept {
+#if defined(PLATFORMIO_ESP32) || defined(ARDUINO_ARCH_ESP32)
+    return (size_t)xPortGetCoreID() % N;
+#elif defined(ARDUINO_ARCH_RP2040) && defined(PICO_SDK_VERSION_MAJOR)
+    return (size_t)get_core_num() % N;
+#elif !defined(ARDUINO)
+    static size_t s_next = 0;
+    static thread_local size_t t_slot =
+        __atomic_fetch_add(&s_next, 1, __ATOMIC_RELAXED) % N;
+    return t_slot;
+#else
+    return 0;
+#endif
+  }
+
+private:
+  struct alignas(64) Slot {
+    UUID7 gen;
+#if defined(UUID7_HAS_SPINLOCK)
+    UUID7SpinLock lock;
+#endif
+  };
+
+#if defined(UUID7_HAS_SPINLOCK)
+  static void _lock(void *l) { static_cast<UUID7SpinLock *>(l)->lock(); }
+  static void _unlock(void *l) { static_cast<UUID7SpinLock *>(l)->unlock(); }
+#endif
+
+  Slot _shards[N];
+  alignas(64) uint32_t _hwm; // Low 32 bits of the shared high-water mark (ms)
+  now_ms_fn _now;
+  void *_now_ctx;
+  uint32_t _regressionThresholdMs;
+
+  /**
+   * @brief Time provider installed on every shard: the real clock raised to
+   * the shared high-water mark. Only the low 32 bits are shared, which is
+   * enough since shards never drift apart by more than the regression
+   * threshold, and keeps the mark lock-free on 32-bit cores.
+   */
+  static uint64_t _clock(void *ctx) {
+    UUID7Sharded *self = static_cast<UUID7Sharded *>(ctx);
+    uint64_t now = self->_now ? self->_now(self->_now_ctx)
+                              : UUID7::default_now_ms(nullptr);
+    if (now == 0)
+      return 0;
+
+    uint32_t now32 = (uint32_t)now;
+    uint32_t hwm = __atomic_load_n(&self->_hwm, __ATOMIC_ACQUIRE);
+    int32_t ahead = (int32_t)(hwm - now32);
+    while (ahead <= 0 || (uint32_t)ahead > self->_regressionThresholdMs) {
+      // This shard leads (or the mark is stale): publish only on change.
+      if (ahead == 0 ||
+          __atomic_compare_exchange_n(&self->_hwm, &hwm, now32, true,
+                                      __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))
+        return now;
+      ahead = (int32_t)(hwm - now32);
+    }
+    // Another shard already moved on: follow it.
+    return now + (uint32_t)ahead;
+  }
+};
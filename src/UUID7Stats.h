@@ -0,0 +1,132 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2026 bkwoka
+// Repository: https://github.com/bkwoka/UUIDv7
+
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#if defined(UUID7_ENABLE_STATS)
+#if defined(ARDUINO)
+#include <Arduino.h>
+#elif defined(PLATFORMIO_ESP32)
+#include "esp_cpu.h"
+#elif defined(PLATFORMIO_NATIVE)
+#include <chrono>
+#endif
+#endif
+
+#ifndef UUID7_STATS_BUCKETS
+#define UUID7_STATS_BUCKETS 24
+#endif
+
+/**
+ * @brief Hot-path counters of a UUID7 instance (see UUID7::getStats()).
+ *
+ * Only collected when the library is built with -DUUID7_ENABLE_STATS;
+ * otherwise the generator carries no counters and getStats() returns false.
+ * Counters are updated with relaxed atomics where 32-bit atomics are
+ * lock-free, so a snapshot taken while other threads generate is
+ * approximate but never torn per field.
+ */
+struct UUID7Stats {
+    uint32_t calls;          // generateBatch()/generate()/reserve() calls
+    uint32_t generated;      // IDs returned (v7 and v4)
+    uint32_t clock_clamps;   // Minor regressions clamped to the last timestamp
+    uint32_t v4_fallbacks;   // IDs emitted as v4 after a major regression
+    uint32_t overflows;      // Attempts that found the counter exhausted
+    uint32_t wait_spins;     // UUID_OVERFLOW_WAIT back-offs
+    uint32_t rng_faults;     // RNG outputs rejected by the health check
+    uint32_t clock_failures; // Clock reads that returned 0
+    uint32_t saves;          // Persistence save() calls (inline and flush)
+    // Call latency histogram: bucket k counts calls that took
+    // [2^k, 2^(k+1)) ticks (bucket 0 also holds 0 and the last bucket
+    // everything above). Ticks are ns on native, CPU cycles on ESP32 and
+    // micros() elsewhere.
+    uint32_t latency[UUID7_STATS_BUCKETS];
+
+    UUID7Stats() noexcept { clear(); }
+
+    void clear() noexcept { memset(this, 0, sizeof(*this)); }
+
+    static void add(uint32_t *p, uint32_t v = 1) noexcept {
+#if defined(__GCC_ATOMIC_INT_LOCK_FREE) && (__GCC_ATOMIC_INT_LOCK_FREE == 2)
+        __atomic_fetch_add(p, v, __ATOMIC_RELAXED);
+#else
+        *p += v;
+#endif
+    }
+
+    static uint32_t read(const uint32_t *p) noexcept {
+#if defined(__GCC_ATOMIC_INT_LOCK_FREE) && (__GCC_ATOMIC_INT_LOCK_FREE == 2)
+        return __atomic_load_n(p, __ATOMIC_RELAXED);
+#else
+        return *p;
+#endif
+    }
+
+    static void write(uint32_t *p, uint32_t v) noexcept {
+#if defined(__GCC_ATOMIC_INT_LOCK_FREE) && (__GCC_ATOMIC_INT_LOCK_FREE == 2)
+        __atomic_store_n(p, v, __ATOMIC_RELAXED);
+#else
+        *p = v;
+#endif
+    }
+
+    /** @brief Histogram bucket for a latency in ticks. */
+    static uint8_t bucket(uint32_t ticks) noexcept {
+        uint8_t k = 0;
+        while (ticks > 1 && k < UUID7_STATS_BUCKETS - 1) {
+            ticks >>= 1;
+            k++;
+        }
+        return k;
+    }
+
+#if defined(UUID7_ENABLE_STATS)
+    /** @brief Free-running tick counter for latency measurement. */
+    static uint32_t ticks() noexcept {
+#if defined(PLATFORMIO_ESP32) || defined(ARDUINO_ARCH_ESP32)
+#if defined(ARDUINO)
+        return ESP.getCycleCount();
+#else
+        return (uint32_t)esp_cpu_get_cycle_count(); // ESP-IDF without Arduino
+#endif
+#elif defined(ARDUINO)
+        return (uint32_t)micros();
+#elif defined(PLATFORMIO_NATIVE)
+        using namespace std::chrono;
+        return (uint32_t)duration_cast<nanoseconds>(
+                   steady_clock::now().time_since_epoch()).count();
+#else
+        return 0;
+#endif
+    }
+#endif
+
+    /** @brief Record one completed call. */
+    void record(size_t ids, uint32_t elapsed_ticks) noexcept {
+        add(&calls);
+        add(&generated, (uint32_t)ids);
+        add(&latency[bucket(elapsed_ticks)]);
+    }
+
+    /** @brief Field-wise relaxed copy into out. */
+    void snapshot(UUID7Stats &out) const noexcept {
+        const uint32_t *src = &calls;
+        uint32_t *dst = &out.calls;
+        for (size_t i = 0; i < sizeof(*this) / sizeof(uint32_t); i++)
+            dst[i] = read(src + i);
+    }
+
+    /** @brief Field-wise relaxed reset. */
+    void reset() noexcept {
+        uint32_t *p = &calls;
+        for (size_t i = 0; i < sizeof(*this) / sizeof(uint32_t); i++)
+            write(p + i, 0);
+    }
+};
+
+static_assert(sizeof(UUID7Stats) == (9 + UUID7_STATS_BUCKETS) * sizeof(uint32_t),
+              "UUID7Stats must hold only uint32_t counters");
@@ -17,10 +17,22 @@ enum UUIDOverflowPolicy {
     UUID_OVERFLOW_WAIT
 };
 
+enum UUIDEntropyMode {
+    UUID_ENTROPY_EVERY_CALL,
+    UUID_ENTROPY_ON_TICK
+};
+
+enum UUIDPersistenceMode {
+    UUID_PERSIST_INLINE,
+    UUID_PERSIST_DEFERRED
+};
+
 namespace uuid7 {
     typedef void (*fill_random_fn)(uint8_t *dest, size_t len, void *ctx);
     typedef uint64_t (*now_ms_fn)(void *ctx);
+    typedef uint64_t (*now_us_fn)(void *ctx);
     typedef void (*uuid_save_fn)(uint64_t timestamp, void *ctx);
     typedef uint64_t (*uuid_load_fn)(void *ctx);
     typedef void (*lock_fn_t)(void);
+    typedef void (*lock_ctx_fn)(void *ctx);
 }
@@ -1,5 +1,6 @@
 #include <unity.h>
 #include "EasyUUID7.h"
+#include <chrono>
 
 void test_easy_wrapper_generation() {
     EasyUUID7 easy;
@@ -55,6 +56,21 @@ void test_easy_wrapper_retry_limit() {
     TEST_ASSERT_FALSE(easy.generate());
 }
 
+/**
+ * @brief Verifies that RNG failures are retried without sleeping to the next
+ * millisecond: only a counter overflow waits for the tick.
+ */
+void test_easy_retry_rng_fault_does_not_sleep() {
+    EasyUUID7 easy(200);
+    easy.setRandomSource(mock_failing_rng);
+
+    auto t0 = std::chrono::steady_clock::now();
+    TEST_ASSERT_FALSE(easy.generate());
+    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - t0).count();
+    TEST_ASSERT_TRUE(ms < 100); // 200 tick sleeps would take ~200 ms
+}
+
 
 /**
  * @brief Verifies that EasyUUID7::parse() correctly synchronizes the internal 
@@ -120,16 +136,49 @@ void test_fromBytes_cache_sync() {
     TEST_ASSERT_TRUE(s.equals(expected));
 }
 
+/**
+ * @brief Verifies that the string cache is only formatted on demand and
+ * that the String-free accessors agree with toString().
+ */
+void test_lazy_cache_views() {
+    EasyUUID7 easy;
+    TEST_ASSERT_TRUE(easy.generate());
+    char first[37];
+    strcpy(first, easy.c_str());
+
+    // Byte-only callers: several generations without reading the string
+    TEST_ASSERT_TRUE(easy.generate());
+    TEST_ASSERT_TRUE(easy.generate());
+    char expected[37];
+    UUID7 ref;
+    ref.fromBytes(easy.data());
+    ref.toString(expected, sizeof(expected));
+    TEST_ASSERT_EQUAL_STRING(expected, easy.c_str());
+    TEST_ASSERT_TRUE(strcmp(first, easy.c_str()) < 0);
+    const char* view = easy;
+    TEST_ASSERT_TRUE(view == easy.c_str());
+
+    char buf[37];
+    TEST_ASSERT_TRUE(easy.toCharArray(buf, sizeof(buf)));
+    TEST_ASSERT_EQUAL_STRING(expected, buf);
+    TEST_ASSERT_FALSE(easy.toCharArray(buf, 36));
+    TEST_ASSERT_TRUE(easy.toCharArray(buf, 33, true, false));
+    TEST_ASSERT_EQUAL_INT(32, strlen(buf));
+    TEST_ASSERT_TRUE(easy.toString(true, false).equals(buf));
+}
+
 void run_easy_tests() {
     UNITY_BEGIN();
     RUN_TEST(test_easy_wrapper_generation);
     RUN_TEST(test_string_conversion);
     RUN_TEST(test_operators);
     RUN_TEST(test_easy_wrapper_retry_limit);
+    RUN_TEST(test_easy_retry_rng_fault_does_not_sleep);
     RUN_TEST(test_easy_parse_cache);
 
     RUN_TEST(test_toCharArray_nil_fallback);
     RUN_TEST(test_fromBytes_cache_sync);
+    RUN_TEST(test_lazy_cache_views);
 
     UNITY_END();
 }
@@ -17,6 +17,21 @@
 #endif
 
 #include "UUID7.h"
+#include "UUID7Sharded.h"
+#include "UUID7EntropyPool.h"
+#include "UUID7Codec.h"
+#include "BasicUUID7.h"
+#include "UUID7Index.h"
+#include "UUID7Scanner.h"
+#include "UUID7Bulk.h"
+#include "UUID7ISR.h"
+#include "UUID7Prefetcher.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <type_traits>
 
 // --- TEST CASES ---
 
@@ -713,6 +728,8 @@ static int s_lock_count   = 0;
 static int s_unlock_count = 0;
 static void counting_lock()   { s_lock_count++;   }
 static void counting_unlock() { s_unlock_count++; }
+static void ctx_lock(void* c)   { static_cast<int*>(c)[0]++; }
+static void ctx_unlock(void* c) { static_cast<int*>(c)[1]++; }
 
 void test_lock_callbacks() {
     s_lock_count = s_unlock_count = 0;
@@ -731,6 +748,15 @@ void test_lock_callbacks() {
     TEST_ASSERT_TRUE(g.generate());
     TEST_ASSERT_TRUE(s_lock_count > prev);
     TEST_ASSERT_EQUAL_INT(s_lock_count, s_unlock_count);
+
+    // Context callbacks receive their own object and replace the plain pair
+    int ctx_counts[2] = {0, 0};
+    prev = s_lock_count;
+    g.setLockCallbacks(ctx_lock, ctx_unlock, ctx_counts);
+    TEST_ASSERT_TRUE(g.generate());
+    TEST_ASSERT_TRUE(ctx_counts[0] > 0);
+    TEST_ASSERT_EQUAL_INT(ctx_counts[0], ctx_counts[1]);
+    TEST_ASSERT_EQUAL_INT(prev, s_lock_count);
 }
 
 void test_getter_lock_callbacks() {
@@ -743,30 +769,1654 @@ void test_getter_lock_callbacks() {
 
     int before = s_lock_count;
 
-    // Each getter must invoke lock/unlock exactly once
+#if defined(UUID7_HAS_SEQLOCK)
+    const int per_getter = 0; // Seqlock readers never take the guard
+#else
+    const int per_getter = 1; // Each getter must invoke lock/unlock exactly once
+#endif
     (void)g.isV7();
-    TEST_ASSERT_EQUAL_INT(before + 1, s_lock_count);
+    TEST_ASSERT_EQUAL_INT(before + 1 * per_getter, s_lock_count);
     TEST_ASSERT_EQUAL_INT(s_lock_count, s_unlock_count);
 
     (void)g.isV4();
-    TEST_ASSERT_EQUAL_INT(before + 2, s_lock_count);
+    TEST_ASSERT_EQUAL_INT(before + 2 * per_getter, s_lock_count);
     TEST_ASSERT_EQUAL_INT(s_lock_count, s_unlock_count);
 
     (void)g.getVariant();
-    TEST_ASSERT_EQUAL_INT(before + 3, s_lock_count);
+    TEST_ASSERT_EQUAL_INT(before + 3 * per_getter, s_lock_count);
     TEST_ASSERT_EQUAL_INT(s_lock_count, s_unlock_count);
 
     (void)g.getTimestamp();
-    TEST_ASSERT_EQUAL_INT(before + 4, s_lock_count);
+    TEST_ASSERT_EQUAL_INT(before + 4 * per_getter, s_lock_count);
     TEST_ASSERT_EQUAL_INT(s_lock_count, s_unlock_count);
 
-    // isValid() invokes isV7() OR isV4() — at least +1 lock
+    // isValid() reads the version once
     int before2 = s_lock_count;
     (void)g.isValid();
-    TEST_ASSERT_TRUE(s_lock_count > before2);
+    TEST_ASSERT_EQUAL_INT(before2 + per_getter, s_lock_count);
     TEST_ASSERT_EQUAL_INT(s_lock_count, s_unlock_count);
+
+    // generate() then toString(): one guard cycle with the seqlock
+    before = s_lock_count;
+    char buf[37];
+    TEST_ASSERT_TRUE(g.generate());
+    TEST_ASSERT_TRUE(g.toString(buf, sizeof(buf)));
+    TEST_ASSERT_EQUAL_INT(before + 1 + per_getter, s_lock_count);
+}
+
+/**
+ * @brief Verifies that generateBatch() produces strictly monotonic v7 IDs
+ * under a single lock cycle and a single RNG call, and persists at most once.
+ */
+static int s_batch_rng_calls = 0;
+static void counting_rng(uint8_t* dest, size_t len, void*) {
+    s_batch_rng_calls++;
+    deterministic_rng(dest, len, nullptr);
+}
+
+void test_generate_batch() {
+    s_lock_count = s_unlock_count = 0;
+    s_batch_rng_calls = 0;
+    save_call_count = 0;
+    mock_nvs_storage = 0;
+    mock_rng_val = 0x10;
+    mock_time_val = 777000;
+
+    UUID7 g(counting_rng, nullptr, mock_now_ms, nullptr);
+    g.setLockCallbacks(counting_lock, counting_unlock);
+    g.setStorage(mock_load_fn, mock_save_fn, nullptr, 1000);
+
+    uint8_t ids[8][16];
+    TEST_ASSERT_TRUE(g.generateBatch(ids, 8) == 8);
+    TEST_ASSERT_EQUAL_INT(1, s_lock_count);
+    TEST_ASSERT_EQUAL_INT(1, s_unlock_count);
+    TEST_ASSERT_EQUAL_INT(1, s_batch_rng_calls);
+    TEST_ASSERT_EQUAL_INT(1, save_call_count);
+
+    for (int i = 0; i < 8; i++) {
+        TEST_ASSERT_EQUAL_UINT8(7, (ids[i][6] >> 4) & 0x0F);
+        TEST_ASSERT_EQUAL_UINT8(2, (ids[i][8] >> 6) & 0x03);
+        if (i > 0) TEST_ASSERT_TRUE(memcmp(ids[i - 1], ids[i], 16) < 0);
+    }
+    TEST_ASSERT_EQUAL_MEMORY(ids[7], g.data(), 16);
+    TEST_ASSERT_TRUE(g.getTimestamp() == 777000);
+
+    // Subsequent single generate() keeps the sequence monotonic
+    TEST_ASSERT_TRUE(g.generate());
+    TEST_ASSERT_TRUE(memcmp(ids[7], g.data(), 16) < 0);
+
+    // Batches longer than UUID7_BATCH_LOCK_SPAN release the guard per span
+    {
+        const int n = 2 * UUID7_BATCH_LOCK_SPAN + 1;
+        static uint8_t big[n][16];
+        s_lock_count = s_unlock_count = 0;
+        TEST_ASSERT_TRUE(g.generateBatch(big, n) == (size_t)n);
+        TEST_ASSERT_EQUAL_INT(3, s_lock_count);
+        TEST_ASSERT_EQUAL_INT(3, s_unlock_count);
+        TEST_ASSERT_TRUE(memcmp(g.data(), big[n - 1], 16) == 0);
+        for (int i = 1; i < n; i++)
+            TEST_ASSERT_TRUE(memcmp(big[i - 1], big[i], 16) < 0);
+    }
+
+    // v4 batches stamp version/variant on every slot
+    g.setVersion(UUID_VERSION_4);
+    TEST_ASSERT_TRUE(g.generateBatch(ids, 4) == 4);
+    for (int i = 0; i < 4; i++) {
+        TEST_ASSERT_EQUAL_UINT8(4, (ids[i][6] >> 4) & 0x0F);
+        TEST_ASSERT_EQUAL_UINT8(2, (ids[i][8] >> 6) & 0x03);
+    }
+
+    // Edge cases and RNG faults
+    TEST_ASSERT_TRUE(g.generateBatch(nullptr, 4) == 0);
+    TEST_ASSERT_TRUE(g.generateBatch(ids, 0) == 0);
+    UUID7 bad(failing_rng, nullptr, mock_now_ms, nullptr);
+    TEST_ASSERT_TRUE(bad.generateBatch(ids, 4) == 0);
+}
+
+/**
+ * @brief Verifies that a batch stops early on counter overflow under
+ * FAIL_FAST and completes across millisecond ticks under WAIT.
+ */
+static void overflow_rng_slots(uint8_t* dest, size_t len, void*) {
+    for (size_t i = 0; i + 16 <= len; i += 16) overflow_rng(dest + i, 16, nullptr);
+}
+
+void test_generate_batch_overflow() {
+    mock_time_val = 5000;
+    dynamic_time_calls = 0;
+
+    uint8_t ids[4][16];
+    UUID7 ff(overflow_rng_slots, nullptr, mock_now_ms, nullptr);
+    TEST_ASSERT_TRUE(ff.generateBatch(ids, 4) == 1);
+
+    UUID7 w(overflow_rng_slots, nullptr, mock_now_ms_overflow, nullptr);
+    w.setOverflowPolicy(UUID_OVERFLOW_WAIT);
+    TEST_ASSERT_TRUE(w.generateBatch(ids, 4) == 4);
+    for (int i = 1; i < 4; i++) {
+        TEST_ASSERT_TRUE(memcmp(ids[i - 1], ids[i], 16) < 0);
+    }
+}
+
+/**
+ * @brief Verifies that UUID_ENTROPY_ON_TICK only draws from the RNG when the
+ * millisecond changes, while keeping IDs monotonic.
+ */
+void test_entropy_on_tick() {
+    s_batch_rng_calls = 0;
+    mock_rng_val = 0x20;
+    mock_time_val = 900000;
+
+    UUID7 g(counting_rng, nullptr, mock_now_ms, nullptr);
+    TEST_ASSERT_TRUE(g.getEntropyMode() == UUID_ENTROPY_EVERY_CALL);
+    g.setEntropyMode(UUID_ENTROPY_ON_TICK);
+    TEST_ASSERT_TRUE(g.getEntropyMode() == UUID_ENTROPY_ON_TICK);
+
+    uint8_t prev[16], cur[16];
+    TEST_ASSERT_TRUE(g.generate(prev));
+    for (int i = 0; i < 50; i++) {
+        TEST_ASSERT_TRUE(g.generate(cur));
+        TEST_ASSERT_TRUE(memcmp(prev, cur, 16) < 0);
+        memcpy(prev, cur, 16);
+    }
+    TEST_ASSERT_EQUAL_INT(1, s_batch_rng_calls);
+
+    uint8_t ids[8][16];
+    TEST_ASSERT_TRUE(g.generateBatch(ids, 8) == 8);
+    TEST_ASSERT_EQUAL_INT(1, s_batch_rng_calls);
+    TEST_ASSERT_TRUE(memcmp(prev, ids[0], 16) < 0);
+
+    // A new millisecond pulls exactly one fresh draw
+    mock_time_val++;
+    TEST_ASSERT_TRUE(g.generateBatch(ids, 8) == 8);
+    TEST_ASSERT_EQUAL_INT(2, s_batch_rng_calls);
+    TEST_ASSERT_TRUE(g.getTimestamp() == mock_time_val);
+
+    // RNG faults are still detected on the tick draw
+    mock_time_val++;
+    g.setRandomSource(failing_rng, nullptr);
+    TEST_ASSERT_FALSE(g.generate());
+}
+
+/**
+ * @brief Verifies the ChaCha20 expander against the RFC 8439 zero-key vector
+ * and that a pool serves a generator, refills, and propagates source faults.
+ */
+static int s_pool_source_calls = 0;
+static void pool_source(uint8_t* dest, size_t len, void*) {
+    s_pool_source_calls++;
+    deterministic_rng(dest, len, nullptr);
+}
+
+static bool s_pool_flaky_dead = false;
+static void flaky_pool_source(uint8_t* dest, size_t len, void*) {
+    s_pool_source_calls++;
+    if (s_pool_flaky_dead) memset(dest, 0, len);
+    else deterministic_rng(dest, len, nullptr);
+}
+
+// Lock callbacks that inject addEntropy() before refill()'s write-back
+// (its third lock: due check, reservation, write-back).
+static UUID7EntropyPool<128>* s_racy_pool = nullptr;
+static int s_racy_locks = 0;
+static void racy_lock() {
+    if (s_racy_pool && ++s_racy_locks == 3) {
+        const uint8_t extra[4] = {1, 2, 3, 4};
+        UUID7EntropyPool<128>* p = s_racy_pool;
+        s_racy_pool = nullptr; // addEntropy() locks too
+        p->addEntropy(extra, sizeof(extra));
+        s_racy_pool = p;
+    }
+}
+static void racy_unlock() {}
+
+void test_entropy_pool() {
+    const uint8_t expected[16] = {0x76, 0xb8, 0xe0, 0xad, 0xa0, 0xf1, 0x3d, 0x90,
+                                  0x40, 0x5d, 0x6a, 0xe5, 0x53, 0x86, 0xbd, 0x28};
+    uint32_t zero_key[8] = {0};
+    uint8_t block[64];
+    uuid_chacha20_block(zero_key, 0, block);
+    TEST_ASSERT_EQUAL_MEMORY(expected, block, 16);
+
+    s_pool_source_calls = 0;
+    mock_rng_val = 0x30;
+    mock_time_val = 123456;
+    UUID7EntropyPool<128> pool(pool_source, nullptr, 1024);
+    TEST_ASSERT_TRUE(pool.available() == 0);
+    TEST_ASSERT_TRUE(pool.refill());
+    TEST_ASSERT_EQUAL_INT(1, s_pool_source_calls);
+    TEST_ASSERT_TRUE(pool.available() == 128);
+    TEST_ASSERT_FALSE(pool.refill()); // still full
+
+    UUID7 g(UUID7EntropyPool<128>::fill, &pool, mock_now_ms, nullptr);
+    g.setVersion(UUID_VERSION_4);
+    uint8_t a[16], b[16];
+    TEST_ASSERT_TRUE(g.generate(a));
+    TEST_ASSERT_TRUE(g.generate(b));
+    TEST_ASSERT_TRUE(pool.available() == 96);
+    TEST_ASSERT_TRUE(memcmp(a, b, 16) != 0);
+
+    // Larger requests bypass the pool; reseeding follows the interval
+    uint8_t ids[64][16];
+    TEST_ASSERT_TRUE(g.generateBatch(ids, 64) == 64);
+    TEST_ASSERT_TRUE(g.generateBatch(ids, 64) == 64);
+    TEST_ASSERT_TRUE(s_pool_source_calls >= 2);
+
+    // A dead hardware source yields zeros, which the generator rejects
+    UUID7EntropyPool<64> dead(failing_rng, nullptr);
+    UUID7 d(UUID7EntropyPool<64>::fill, &dead, mock_now_ms, nullptr);
+    TEST_ASSERT_FALSE(d.generate());
+
+    // A source that dies after seeding: reseed() reports it and backs off
+    // instead of being retried on every read
+    s_pool_flaky_dead = false;
+    s_pool_source_calls = 0;
+    UUID7EntropyPool<128> flaky(flaky_pool_source, nullptr, 2048);
+    TEST_ASSERT_TRUE(flaky.reseed());
+    s_pool_flaky_dead = true;
+    TEST_ASSERT_FALSE(flaky.reseed());
+    uint8_t out[16];
+    for (int i = 0; i < 1000; i++) // 16000 bytes
+        flaky.read(out, sizeof(out));
+    int calls = s_pool_source_calls;
+    TEST_ASSERT_TRUE(calls >= 3 && calls <= 2 + 16000 / 1024 + 1);
+
+    // A key change during refill()'s unlocked expansion drops its output
+    UUID7EntropyPool<128> racy(pool_source, nullptr, 0);
+    TEST_ASSERT_TRUE(racy.refill());
+    uint8_t drain[80];
+    racy.read(drain, sizeof(drain)); // Below half full
+    s_racy_pool = &racy;
+    s_racy_locks = 0;
+    racy.setLockCallbacks(racy_lock, racy_unlock);
+    TEST_ASSERT_FALSE(racy.refill());
+    TEST_ASSERT_TRUE(racy.available() == 0); // addEntropy() discarded the buffer
+    s_racy_pool = nullptr;
+    TEST_ASSERT_TRUE(racy.refill());
+    TEST_ASSERT_TRUE(racy.available() == 128);
+}
+
+/**
+ * @brief Cross-checks the active codec path (SIMD / LUT / scalar) against a
+ * reference nibble-loop codec on random inputs, all formats and every
+ * invalid-character position.
+ */
+static void ref_encode(const uint8_t b[16], char* out, bool upper, bool dashes) {
+    const char* hex = upper ? "0123456789ABCDEF" : "0123456789abcdef";
+    for (int i = 0; i < 16; i++) {
+        if (dashes && (i == 4 || i == 6 || i == 8 || i == 10)) *out++ = '-';
+        *out++ = hex[b[i] >> 4];
+        *out++ = hex[b[i] & 0x0F];
+    }
+    *out = '\0';
+}
+
+void test_codec_paths() {
+    uint8_t bytes[16], back[16];
+    char got[37], want[37];
+    uint32_t x = 0x9E3779B9;
+    for (int iter = 0; iter < 500; iter++) {
+        for (int i = 0; i < 16; i++) { x = x * 1664525u + 1013904223u; bytes[i] = (uint8_t)(x >> 24); }
+        for (int f = 0; f < 4; f++) {
+            bool upper = f & 1, dashes = f & 2;
+            TEST_ASSERT_TRUE(UUID7Codec::encode(bytes, got, sizeof(got), upper, dashes));
+            ref_encode(bytes, want, upper, dashes);
+            TEST_ASSERT_EQUAL_STRING(want, got);
+            TEST_ASSERT_TRUE(UUID7Codec::decode(got, back));
+            TEST_ASSERT_EQUAL_MEMORY(bytes, back, 16);
+        }
+    }
+
+    // Length-known overload needs no terminator
+    char raw[40];
+    ref_encode(bytes, raw, false, true);
+    raw[36] = 'Z';
+    TEST_ASSERT_TRUE(UUID7Codec::decode(raw, 36, back));
+    TEST_ASSERT_EQUAL_MEMORY(bytes, back, 16);
+    TEST_ASSERT_FALSE(UUID7Codec::decode(raw, 35, back));
+    TEST_ASSERT_TRUE(UUID7::parseFromString(raw, 36, back));
+
+    // Every position rejects non-hex characters, including neighbours of the ranges
+    const char bad_chars[] = {'g', 'G', '/', ':', '@', '`', ' ', (char)0x80, (char)0xC6};
+    ref_encode(bytes, raw, false, false);
+    for (int pos = 0; pos < 32; pos++) {
+        for (size_t k = 0; k < sizeof(bad_chars); k++) {
+            char mutated[33];
+            memcpy(mutated, raw, 33);
+            mutated[pos] = bad_chars[k];
+            TEST_ASSERT_FALSE(UUID7Codec::decode(mutated, 32, back));
+        }
+    }
+    ref_encode(bytes, raw, false, true);
+    raw[13] = '0';
+    TEST_ASSERT_FALSE(UUID7Codec::decode(raw, back));
+}
+
+/**
+ * @brief Verifies encodeMany()/decodeMany() against the single-item codec for
+ * all flag combinations, strided output and the per-item validity mask.
+ */
+void test_codec_bulk() {
+    const size_t kN = 7;
+    uint8_t in[kN][16], back[kN][16];
+    for (size_t i = 0; i < kN; i++)
+        for (int k = 0; k < 16; k++) in[i][k] = (uint8_t)(i * 31 + k * 17 + 5);
+
+    char buf[kN * 40];
+    for (unsigned flags = 0; flags < 8; flags++) {
+        bool upper = flags & UUID7Codec::UPPERCASE, dashes = !(flags & UUID7Codec::NO_DASHES);
+        size_t width = dashes ? 36 : 32;
+        memset(buf, ',', sizeof(buf));
+        TEST_ASSERT_TRUE(UUID7Codec::encodeMany(in, kN, buf, 40, flags) == kN);
+        for (size_t i = 0; i < kN; i++) {
+            char want[37];
+            UUID7Codec::encode(in[i], want, sizeof(want), upper, dashes);
+            TEST_ASSERT_TRUE(memcmp(buf + i * 40, want, width) == 0);
+            TEST_ASSERT_EQUAL_UINT8((flags & UUID7Codec::TERMINATE) ? '\0' : ',', buf[i * 40 + width]);
+            TEST_ASSERT_EQUAL_UINT8(',', buf[i * 40 + 39]);
+        }
+        uint8_t valid[1];
+        TEST_ASSERT_TRUE(UUID7Codec::decodeMany(buf, kN, 40, back, valid, flags) == kN);
+        TEST_ASSERT_EQUAL_UINT8(0x7F, valid[0]);
+        TEST_ASSERT_EQUAL_MEMORY(in, back, sizeof(in));
+    }
+
+    // Corrupted items are reported and zeroed
+    UUID7Codec::encodeMany(in, kN, buf, 37, 0);
+    buf[2 * 37 + 5] = 'x';
+    buf[6 * 37 + 8] = '0';
+    uint8_t valid[1];
+    TEST_ASSERT_TRUE(UUID7Codec::decodeMany(buf, kN, 37, back, valid) == kN - 2);
+    TEST_ASSERT_EQUAL_UINT8(0x3B, valid[0]);
+    uint8_t zero[16] = {0};
+    TEST_ASSERT_EQUAL_MEMORY(zero, back[2], 16);
+
+    // Stride too small for the requested format
+    TEST_ASSERT_TRUE(UUID7Codec::encodeMany(in, kN, buf, 36, UUID7Codec::TERMINATE) == 0);
+    TEST_ASSERT_TRUE(UUID7Codec::decodeMany(buf, kN, 35, back, valid) == 0);
+}
+
+/**
+ * @brief Verifies Base32 (Crockford) / Base64url vectors, round trips and
+ * order preservation, and the varint-delta run format.
+ */
+void test_compact_encodings() {
+    uint8_t zero[16] = {0}, ones[16], back[16];
+    memset(ones, 0xFF, 16);
+    char b32[27], b64[23];
+    TEST_ASSERT_TRUE(UUID7Codec::encodeBase32(zero, b32, sizeof(b32)));
+    TEST_ASSERT_EQUAL_STRING("00000000000000000000000000", b32);
+    TEST_ASSERT_TRUE(UUID7Codec::encodeBase32(ones, b32, sizeof(b32)));
+    TEST_ASSERT_EQUAL_STRING("7ZZZZZZZZZZZZZZZZZZZZZZZZZ", b32);
+    TEST_ASSERT_TRUE(UUID7Codec::encodeBase64Url(ones, b64, sizeof(b64)));
+    TEST_ASSERT_EQUAL_STRING("_____________________w", b64);
+    TEST_ASSERT_FALSE(UUID7Codec::encodeBase32(ones, b32, 26));
+    TEST_ASSERT_FALSE(UUID7Codec::decodeBase32("8ZZZZZZZZZZZZZZZZZZZZZZZZZ", 26, back));
+    TEST_ASSERT_FALSE(UUID7Codec::decodeBase32("0000000000000000000000000U", 26, back));
+    TEST_ASSERT_FALSE(UUID7Codec::decodeBase64Url("_____________________x", 22, back));
+    TEST_ASSERT_TRUE(UUID7Codec::decodeBase32("0000000000000000000000000i", 26, back));
+    TEST_ASSERT_EQUAL_UINT8(1, back[15]);
+
+    mock_time_val = 1700000000000ULL;
+    UUID7 g(nullptr, nullptr, mock_now_ms, nullptr);
+    uint8_t ids[64][16];
+    TEST_ASSERT_TRUE(g.generateBatch(ids, 32) == 32);
+    mock_time_val += 5;
+    TEST_ASSERT_TRUE(g.generateBatch(ids + 32, 32) == 32);
+    char prev32[27] = "";
+    for (int i = 0; i < 64; i++) {
+        TEST_ASSERT_TRUE(UUID7Codec::encodeBase32(ids[i], b32, sizeof(b32)));
+        TEST_ASSERT_TRUE(UUID7Codec::decodeBase32(b32, 26, back));
+        TEST_ASSERT_EQUAL_MEMORY(ids[i], back, 16);
+        TEST_ASSERT_TRUE(strcmp(prev32, b32) < 0);
+        memcpy(prev32, b32, 27);
+        TEST_ASSERT_TRUE(UUID7Codec::encodeBase64Url(ids[i], b64, sizeof(b64)));
+        TEST_ASSERT_TRUE(UUID7Codec::decodeBase64Url(b64, 22, back));
+        TEST_ASSERT_EQUAL_MEMORY(ids[i], back, 16);
+    }
+    TEST_ASSERT_TRUE(g.toBase32(b32, sizeof(b32)));
+    TEST_ASSERT_TRUE(UUID7Codec::decodeBase32(b32, 26, back));
+    TEST_ASSERT_EQUAL_MEMORY(g.data(), back, 16);
+    TEST_ASSERT_TRUE(g.toBase64Url(b64, sizeof(b64)));
+    TEST_ASSERT_FALSE(g.toBase64Url(b64, 22));
+
+    // Delta run: far smaller than raw, lossless, rejects unsorted/truncated input
+    uint8_t run[64 * 19], decoded[64][16];
+    size_t len = UUID7Codec::encodeDeltaRun(ids, 64, run, sizeof(run));
+    TEST_ASSERT_TRUE(len > 0 && len < 64 * 16 / 2);
+    TEST_ASSERT_TRUE(UUID7Codec::decodeDeltaRun(run, len, decoded, 64) == 64);
+    TEST_ASSERT_EQUAL_MEMORY(ids, decoded, sizeof(ids));
+    TEST_ASSERT_TRUE(UUID7Codec::decodeDeltaRun(run, 5, decoded, 64) == 0); // cut inside a varint
+    TEST_ASSERT_TRUE(UUID7Codec::decodeDeltaRun(run, len, decoded, 63) == 0);
+    TEST_ASSERT_TRUE(UUID7Codec::encodeDeltaRun(ids, 64, run, len - 1) == 0);
+    uint8_t extremes[2][16];
+    memset(extremes[0], 0, 16);
+    memset(extremes[1], 0xFF, 16);
+    len = UUID7Codec::encodeDeltaRun(extremes, 2, run, sizeof(run));
+    TEST_ASSERT_TRUE(len == 1 + 19);
+    TEST_ASSERT_TRUE(UUID7Codec::decodeDeltaRun(run, len, decoded, 2) == 2);
+    TEST_ASSERT_EQUAL_MEMORY(extremes, decoded, 32);
+    memcpy(extremes[0], ones, 16);
+    memset(extremes[1], 0, 16);
+    TEST_ASSERT_TRUE(UUID7Codec::encodeDeltaRun(extremes, 2, run, sizeof(run)) == 0);
+}
+
+static uint64_t mock_time_us = 0;
+static uint64_t mock_now_us(void*) { return mock_time_us; }
+
+/**
+ * @brief Verifies that sub-millisecond mode stores the scaled fraction in
+ * rand_a, orders same-ms IDs by time, and round-trips getTimestampMicros().
+ */
+void test_sub_millisecond_precision() {
+    UUID7 g;
+    g.setPrecisionTimeProvider(mock_now_us);
+    g.setSubMillisecondPrecision(true);
+    TEST_ASSERT_TRUE(g.getSubMillisecondPrecision());
+
+    uint8_t prev[16] = {0}, cur[16];
+    for (uint64_t us = 0; us < 1000; us++) {
+        mock_time_us = 1700000000000000ULL + us;
+        TEST_ASSERT_TRUE(g.generate(cur));
+        TEST_ASSERT_TRUE(memcmp(prev, cur, 16) < 0);
+        uint16_t frac = (uint16_t)(((cur[6] & 0x0F) << 8) | cur[7]);
+        TEST_ASSERT_TRUE(frac == us * 4096 / 1000);
+        TEST_ASSERT_TRUE(g.getTimestamp() == 1700000000000ULL);
+        TEST_ASSERT_TRUE(g.getTimestampMicros() == mock_time_us);
+        memcpy(prev, cur, 16);
+    }
+
+    // Same microsecond, then a regression within the millisecond: rand_a is
+    // kept and only the counter moves.
+    uint8_t a[16], b[16];
+    TEST_ASSERT_TRUE(g.generate(a));
+    mock_time_us -= 500;
+    TEST_ASSERT_TRUE(g.generate(b));
+    TEST_ASSERT_TRUE(memcmp(prev, a, 16) < 0 && memcmp(a, b, 16) < 0);
+    TEST_ASSERT_EQUAL_MEMORY(prev, b, 8);
+
+    // Custom ms clock without a us clock: mode inactive, ms clock honoured
+    mock_time_val = 1234567;
+    UUID7 ms_only(nullptr, nullptr, mock_now_ms, nullptr);
+    ms_only.setSubMillisecondPrecision(true);
+    TEST_ASSERT_TRUE(ms_only.generate());
+    TEST_ASSERT_TRUE(ms_only.getTimestamp() == 1234567);
+
+    // Default platform clock
+    UUID7 native;
+    native.setSubMillisecondPrecision(true);
+    TEST_ASSERT_TRUE(native.generate());
+    TEST_ASSERT_TRUE(native.getTimestampMicros() / 1000 == native.getTimestamp());
+}
+
+/**
+ * @brief Verifies non-destructive counter overflow, the counter seed width
+ * and random increments.
+ */
+void test_counter_modes() {
+    static uint8_t full[16];
+    memset(full, 0xFF, 16);
+    full[0] = 0x12; // keep the RNG fault check happy
+    auto full_rng = [](uint8_t* dest, size_t len, void*) {
+        for (size_t i = 0; i < len; i += 16) memcpy(dest + i, full, 16);
+    };
+
+    // Overflow leaves the last ID in place, also on later calls in the same ms
+    mock_time_val = 1000;
+    UUID7 g(full_rng, nullptr, mock_now_ms, nullptr);
+    TEST_ASSERT_TRUE(g.generate());
+    uint8_t last[16];
+    memcpy(last, g.data(), 16);
+    TEST_ASSERT_FALSE(g.generate());
+    TEST_ASSERT_FALSE(g.generate());
+    TEST_ASSERT_EQUAL_MEMORY(last, g.data(), 16);
+    mock_time_val++;
+    TEST_ASSERT_TRUE(g.generate());
+    TEST_ASSERT_TRUE(memcmp(last, g.data(), 16) < 0);
+
+    // Seed width: only the low 10 bits are random, the rest start at zero
+    g.setCounterSeedBits(10);
+    TEST_ASSERT_EQUAL_UINT8(10, g.getCounterSeedBits());
+    mock_time_val++;
+    TEST_ASSERT_TRUE(g.generate());
+    const uint8_t* b = g.data();
+    TEST_ASSERT_EQUAL_UINT8(0x70, b[6]);
+    TEST_ASSERT_EQUAL_UINT8(0x00, b[7]);
+    TEST_ASSERT_EQUAL_UINT8(0x80, b[8]);
+    for (int i = 9; i < 14; i++) TEST_ASSERT_EQUAL_UINT8(0x00, b[i]);
+    TEST_ASSERT_EQUAL_UINT8(0x03, b[14]);
+    TEST_ASSERT_EQUAL_UINT8(0xFF, b[15]);
+    TEST_ASSERT_TRUE(g.generate());
+    TEST_ASSERT_EQUAL_UINT8(0x04, b[14]);
+    TEST_ASSERT_EQUAL_UINT8(0x00, b[15]);
+
+    // Random increments: strictly increasing, steps within 1..2^8
+    mock_time_val = 5000;
+    UUID7 r(nullptr, nullptr, mock_now_ms, nullptr);
+    r.setRandomIncrement(8);
+    TEST_ASSERT_EQUAL_UINT8(8, r.getRandomIncrement());
+    uint8_t ids[64][16];
+    TEST_ASSERT_TRUE(r.generateBatch(ids, 64) == 64);
+    bool varied = false;
+    for (int i = 1; i < 64; i++) {
+        TEST_ASSERT_TRUE(memcmp(ids[i - 1], ids[i], 16) < 0);
+        uint64_t a = 0, c = 0;
+        for (int k = 9; k < 16; k++) {
+            a = (a << 8) | ids[i - 1][k];
+            c = (c << 8) | ids[i][k];
+        }
+        TEST_ASSERT_TRUE(c - a >= 1 && c - a <= 256);
+        varied = varied || (c - a != 1);
+    }
+    TEST_ASSERT_TRUE(varied);
+}
+
+/**
+ * @brief Verifies deferred persistence: generate() only publishes the
+ * high-water mark, flushStorage() writes it once, and an overdue flush falls
+ * back to a single inline save.
+ */
+void test_deferred_persistence() {
+    mock_nvs_storage = 5000;
+    mock_time_val = 6000;
+    save_call_count = 0;
+
+    UUID7 g(nullptr, nullptr, mock_now_ms, nullptr);
+    g.setStorage(mock_load_fn, mock_save_fn, nullptr, 1000);
+    g.setPersistenceMode(UUID_PERSIST_DEFERRED);
+    TEST_ASSERT_TRUE(g.getPersistenceMode() == UUID_PERSIST_DEFERRED);
+    g.load();
+    // The jump target is published by load() and written in setup()
+    TEST_ASSERT_TRUE(g.isStoragePending());
+    TEST_ASSERT_TRUE(g.flushStorage());
+    TEST_ASSERT_TRUE(mock_nvs_storage == 6000);
+    TEST_ASSERT_FALSE(g.isStoragePending());
+    save_call_count = 0;
+
+    for (mock_time_val = 6000; mock_time_val <= 6600; mock_time_val += 100) {
+        TEST_ASSERT_TRUE(g.generate());
+    }
+    TEST_ASSERT_EQUAL_INT(0, save_call_count);
+    TEST_ASSERT_TRUE(g.isStoragePending());
+
+    // Updates coalesce into one write of the latest mark
+    TEST_ASSERT_TRUE(g.flushStorage());
+    TEST_ASSERT_EQUAL_INT(1, save_call_count);
+    TEST_ASSERT_TRUE(mock_nvs_storage == 6600);
+    TEST_ASSERT_FALSE(g.isStoragePending());
+    TEST_ASSERT_FALSE(g.flushStorage());
+
+    // Less than half an interval ahead: only a forced flush writes
+    mock_time_val = 6700;
+    TEST_ASSERT_TRUE(g.generate());
+    TEST_ASSERT_FALSE(g.flushStorage());
+    TEST_ASSERT_TRUE(g.flushStorage(true));
+    TEST_ASSERT_EQUAL_INT(2, save_call_count);
+
+    // No flush for a full interval: one inline save keeps the safety jump valid
+    mock_time_val = 7800;
+    TEST_ASSERT_TRUE(g.generate());
+    TEST_ASSERT_EQUAL_INT(3, save_call_count);
+    TEST_ASSERT_TRUE(mock_nvs_storage == 7800);
+    mock_time_val = 7801;
+    TEST_ASSERT_TRUE(g.generate());
+    TEST_ASSERT_EQUAL_INT(3, save_call_count);
+}
+
+/**
+ * @brief Verifies lease persistence: one write per lease, renewed a margin
+ * before it runs out, and load() resuming past the stored lease end.
+ */
+void test_storage_lease() {
+    mock_nvs_storage = 50000;
+    save_call_count = 0;
+
+    UUID7 g(nullptr, nullptr, mock_now_ms, nullptr);
+    g.setStorage(mock_load_fn, mock_save_fn, nullptr);
+    g.setStorageLease(10000, 1000);
+    g.load();
+
+    mock_time_val = 50001;
+    TEST_ASSERT_TRUE(g.generate());
+    TEST_ASSERT_EQUAL_INT(1, save_call_count);
+    TEST_ASSERT_TRUE(mock_nvs_storage == 60001);
+    for (mock_time_val = 50002; mock_time_val < 59001; mock_time_val += 7) {
+        TEST_ASSERT_TRUE(g.generate());
+    }
+    TEST_ASSERT_EQUAL_INT(1, save_call_count);
+    mock_time_val = 59001;
+    TEST_ASSERT_TRUE(g.generate());
+    TEST_ASSERT_EQUAL_INT(2, save_call_count);
+    TEST_ASSERT_TRUE(mock_nvs_storage == 69001);
+
+    // Reboot with the clock behind the lease: IDs resume after the lease end
+    UUID7 r(nullptr, nullptr, mock_now_ms, nullptr);
+    r.setStorage(mock_load_fn, mock_save_fn, nullptr);
+    r.setStorageLease(10000, 1000);
+    r.load();
+    mock_time_val = 60000;
+    TEST_ASSERT_TRUE(r.generate());
+    TEST_ASSERT_TRUE(r.isV7());
+    TEST_ASSERT_TRUE(r.getTimestamp() == 69002);
+
+    // Deferred lease: load() publishes the next lease for a setup() flush
+    UUID7 d(nullptr, nullptr, mock_now_ms, nullptr);
+    d.setStorage(mock_load_fn, mock_save_fn, nullptr);
+    d.setStorageLease(10000, 1000);
+    d.setPersistenceMode(UUID_PERSIST_DEFERRED);
+    mock_nvs_storage = 80000;
+    d.load();
+    TEST_ASSERT_TRUE(d.flushStorage());
+    TEST_ASSERT_TRUE(mock_nvs_storage == 90001);
+    save_call_count = 0;
+    for (mock_time_val = 80001; mock_time_val < 89001; mock_time_val += 50) {
+        TEST_ASSERT_TRUE(d.generate());
+    }
+    TEST_ASSERT_EQUAL_INT(0, save_call_count);
+    TEST_ASSERT_FALSE(d.isStoragePending());
+}
+
+/**
+ * @brief Verifies reserve(): one timestamp, consecutive counter values in
+ * index order, lazy materialization, and the overflow policy.
+ */
+void test_reserve_range() {
+    mock_time_val = 424242;
+    UUID7 g(nullptr, nullptr, mock_now_ms, nullptr);
+    uint8_t before[16], prev[16], id[16];
+    TEST_ASSERT_TRUE(g.generate(before));
+
+    UUID7Range r;
+    TEST_ASSERT_FALSE(g.reserve(0, r));
+    TEST_ASSERT_TRUE(g.reserve(1000, r));
+    TEST_ASSERT_EQUAL_INT(1000, (int)r.size());
+    memcpy(prev, before, 16);
+    size_t count = 0;
+    for (const uint8_t* p : r) {
+        TEST_ASSERT_TRUE(memcmp(prev, p, 16) < 0);
+        TEST_ASSERT_EQUAL_MEMORY(before, p, 6);
+        TEST_ASSERT_EQUAL_UINT8(0x70, p[6] & 0xF0);
+        TEST_ASSERT_EQUAL_UINT8(0x80, p[8] & 0xC0);
+        memcpy(prev, p, 16);
+        count++;
+    }
+    TEST_ASSERT_EQUAL_INT(1000, (int)count);
+    TEST_ASSERT_EQUAL_MEMORY(prev, g.data(), 16);
+    TEST_ASSERT_TRUE(r.get(999, id));
+    TEST_ASSERT_EQUAL_MEMORY(prev, id, 16);
+    TEST_ASSERT_FALSE(r.get(1000, id));
+
+    // The generator continues after the range
+    TEST_ASSERT_TRUE(g.generate(id));
+    TEST_ASSERT_TRUE(memcmp(prev, id, 16) < 0);
+
+    // Not enough counter space left in this millisecond: FAIL_FAST
+    static uint8_t full[16];
+    memset(full, 0xFF, 16);
+    full[0] = 0x12;
+    auto full_rng = [](uint8_t* dest, size_t len, void*) {
+        for (size_t i = 0; i < len; i += 16) memcpy(dest + i, full, 16);
+    };
+    UUID7 o(full_rng, nullptr, mock_now_ms, nullptr);
+    TEST_ASSERT_TRUE(o.reserve(1, r));
+    mock_time_val++;
+    TEST_ASSERT_FALSE(o.reserve(2, r));
+    TEST_ASSERT_TRUE(r.empty());
+
+    g.setVersion(UUID_VERSION_4);
+    TEST_ASSERT_FALSE(g.reserve(10, r));
+}
+
+/** @brief Verifies the compile-time configured generator matches UUID7 semantics. */
+void test_basic_template() {
+    typedef BasicUUID7<uuid7::policy::DefaultRng,
+                       uuid7::policy::FnClock<mock_now_ms>,
+                       uuid7::policy::NoLock> Local;
+    mock_time_val = 777000;
+    Local g;
+    uint8_t prev[16], id[16];
+    TEST_ASSERT_TRUE(g.generate(prev));
+    TEST_ASSERT_EQUAL_UINT8(0x70, prev[6] & 0xF0);
+    TEST_ASSERT_EQUAL_UINT8(0x80, prev[8] & 0xC0);
+    for (int i = 0; i < 1000; i++) {
+        TEST_ASSERT_TRUE(g.generate(id));
+        TEST_ASSERT_TRUE(memcmp(prev, id, 16) < 0);
+        memcpy(prev, id, 16);
+    }
+    TEST_ASSERT_EQUAL_MEMORY(id, g.data(), 16);
+    uint64_t ts = 0;
+    for (int i = 0; i < 6; i++) ts = (ts << 8) | id[i];
+    TEST_ASSERT_TRUE(ts == 777000);
+    char s[37];
+    TEST_ASSERT_TRUE(g.toString(s, sizeof(s)));
+    TEST_ASSERT_TRUE(UUID7::parseFromString(s, prev));
+    TEST_ASSERT_EQUAL_MEMORY(id, prev, 16);
+    TEST_ASSERT_TRUE(sizeof(Local) < sizeof(UUID7));
+
+    // Counter exhaustion: FAIL_FAST, or WAIT for the next tick
+    BasicUUID7<uuid7::policy::FnRng<overflow_rng>,
+               uuid7::policy::FnClock<mock_now_ms>,
+               uuid7::policy::NoLock> full;
+    TEST_ASSERT_TRUE(full.generate());
+    TEST_ASSERT_FALSE(full.generate());
+    mock_time_val = 5000;
+    dynamic_time_calls = 0;
+    BasicUUID7<uuid7::policy::FnRng<overflow_rng>,
+               uuid7::policy::FnClock<mock_now_ms_overflow>,
+               uuid7::policy::GuardLock, uuid7::policy::NoPersistence,
+               uuid7::policy::Behaviour<UUID_OVERFLOW_WAIT> > waiting;
+    TEST_ASSERT_TRUE(waiting.generate());
+    TEST_ASSERT_TRUE(waiting.generate(id));
+    ts = 0;
+    for (int i = 0; i < 6; i++) ts = (ts << 8) | id[i];
+    TEST_ASSERT_TRUE(ts > 5000);
+
+    // Periodic persistence and the load() safety jump
+    mock_nvs_storage = 0;
+    save_call_count = 0;
+    mock_time_val = 100000;
+    typedef BasicUUID7<uuid7::policy::DefaultRng,
+                       uuid7::policy::FnClock<mock_now_ms>,
+                       uuid7::policy::NoLock,
+                       uuid7::policy::FnPersistence<mock_load_fn, mock_save_fn, 1000> >
+        Persisted;
+    Persisted p;
+    TEST_ASSERT_TRUE(p.generate());
+    TEST_ASSERT_EQUAL_INT(1, save_call_count);
+    TEST_ASSERT_TRUE(mock_nvs_storage == 100000);
+    mock_time_val = 100500;
+    TEST_ASSERT_TRUE(p.generate());
+    TEST_ASSERT_EQUAL_INT(1, save_call_count);
+    mock_time_val = 101001;
+    TEST_ASSERT_TRUE(p.generate());
+    TEST_ASSERT_EQUAL_INT(2, save_call_count);
+
+    mock_time_val = 101500; // Clock behind the last save after reboot
+    Persisted q;
+    q.load();
+    TEST_ASSERT_TRUE(q.generate(id));
+    ts = 0;
+    for (int i = 0; i < 6; i++) ts = (ts << 8) | id[i];
+    TEST_ASSERT_TRUE(ts == 102001);
+}
+
+/** @brief Verifies the default clock follows a monotonic source plus one wall anchor. */
+void test_clock_anchor() {
+    using namespace std::chrono;
+    uint64_t wall = (uint64_t)duration_cast<milliseconds>(
+        system_clock::now().time_since_epoch()).count();
+    uint64_t now = UUID7::default_now_ms(nullptr);
+    TEST_ASSERT_TRUE(now + 1000 > wall && now < wall + 1000);
+
+    UUID7::setClockAnchor(1000000000000ULL);
+    uint64_t a = UUID7::default_now_ms(nullptr);
+    uint64_t us = UUID7::default_now_us(nullptr);
+    uint64_t b = UUID7::default_now_ms(nullptr);
+    TEST_ASSERT_TRUE(a >= 1000000000000ULL && a < 1000000000000ULL + 1000);
+    TEST_ASSERT_TRUE(a <= b);
+    TEST_ASSERT_TRUE(us / 1000 >= a && us / 1000 <= b);
+
+    UUID7 g;
+    TEST_ASSERT_TRUE(g.generate());
+    TEST_ASSERT_TRUE(g.getTimestamp() >= a && g.getTimestamp() < a + 1000);
+
+    // 0 re-anchors to system_clock on the next read
+    UUID7::setClockAnchor(0);
+    now = UUID7::default_now_ms(nullptr);
+    TEST_ASSERT_TRUE(now + 1000 > wall && now < wall + 2000);
+}
+
+/** @brief Verifies the opt-in hot-path counters (UUID7_ENABLE_STATS). */
+void test_stats() {
+    mock_time_val = 900000;
+    UUID7 g(nullptr, nullptr, mock_now_ms, nullptr);
+    UUID7Stats st;
+#if !defined(UUID7_ENABLE_STATS)
+    TEST_ASSERT_TRUE(g.generate());
+    TEST_ASSERT_FALSE(g.getStats(st));
+    TEST_ASSERT_EQUAL_INT(0, (int)st.calls);
+#else
+    TEST_ASSERT_TRUE(g.getStats(st));
+    TEST_ASSERT_EQUAL_INT(0, (int)st.calls);
+
+    uint8_t batch[8][16];
+    TEST_ASSERT_TRUE(g.generate());
+    TEST_ASSERT_EQUAL_INT(8, (int)g.generateBatch(batch, 8));
+    mock_time_val -= 5; // Minor regression: clamped
+    TEST_ASSERT_TRUE(g.generate());
+    mock_time_val -= 20000; // Major regression: v4 fallback
+    TEST_ASSERT_TRUE(g.generate());
+    TEST_ASSERT_TRUE(g.isV4());
+    mock_time_val = 0; // Clock failure
+    TEST_ASSERT_FALSE(g.generate());
+    mock_time_val = 900001;
+
+    TEST_ASSERT_TRUE(g.getStats(st));
+    TEST_ASSERT_EQUAL_INT(5, (int)st.calls);
+    TEST_ASSERT_EQUAL_INT(11, (int)st.generated);
+    TEST_ASSERT_EQUAL_INT(1, (int)st.clock_clamps);
+    TEST_ASSERT_EQUAL_INT(1, (int)st.v4_fallbacks);
+    TEST_ASSERT_EQUAL_INT(1, (int)st.clock_failures);
+    uint32_t hist = 0;
+    for (int i = 0; i < UUID7_STATS_BUCKETS; i++) hist += st.latency[i];
+    TEST_ASSERT_EQUAL_INT(5, (int)hist);
+
+    // RNG faults, overflow and WAIT back-offs
+    UUID7 bad(failing_rng, nullptr, mock_now_ms, nullptr);
+    TEST_ASSERT_FALSE(bad.generate());
+    TEST_ASSERT_TRUE(bad.getStats(st));
+    TEST_ASSERT_EQUAL_INT(1, (int)st.rng_faults);
+
+    mock_time_val = 5000;
+    dynamic_time_calls = 0;
+    UUID7 w(overflow_rng, nullptr, mock_now_ms_overflow, nullptr);
+    w.setOverflowPolicy(UUID_OVERFLOW_WAIT);
+    TEST_ASSERT_TRUE(w.generate());
+    TEST_ASSERT_TRUE(w.generate());
+    TEST_ASSERT_TRUE(w.getStats(st));
+    TEST_ASSERT_TRUE(st.overflows >= 1);
+    TEST_ASSERT_TRUE(st.wait_spins >= 1);
+    TEST_ASSERT_EQUAL_INT(st.overflows, st.wait_spins);
+
+    // Persistence saves
+    mock_nvs_storage = 0;
+    mock_time_val = 100000;
+    UUID7 p(nullptr, nullptr, mock_now_ms, nullptr);
+    p.setStorage(mock_load_fn, mock_save_fn, nullptr, 1000);
+    TEST_ASSERT_TRUE(p.generate());
+    mock_time_val += 2000;
+    TEST_ASSERT_TRUE(p.generate());
+    TEST_ASSERT_TRUE(p.getStats(st));
+    TEST_ASSERT_EQUAL_INT(2, (int)st.saves);
+
+    p.resetStats();
+    TEST_ASSERT_TRUE(p.getStats(st));
+    TEST_ASSERT_EQUAL_INT(0, (int)st.calls);
+    TEST_ASSERT_EQUAL_INT(0, (int)st.saves);
+#endif
+}
+
+static int s_wait_rng_calls = 0;
+static void counting_overflow_rng(uint8_t* dest, size_t len, void*) {
+    s_wait_rng_calls++;
+    overflow_rng(dest, len, nullptr);
+}
+
+static uint64_t stepping_time_val = 0;
+static uint64_t stepping_now_ms(void*) { return stepping_time_val++; }
+
+/** @brief Verifies WAIT sleeps to the next tick without RNG calls and honours the timeout. */
+void test_overflow_wait_deadline() {
+    UUID7 g(counting_overflow_rng, nullptr, nullptr, nullptr);
+    g.setOverflowPolicy(UUID_OVERFLOW_WAIT);
+    TEST_ASSERT_EQUAL_INT(0, (int)g.getOverflowTimeout());
+    s_wait_rng_calls = 0;
+    uint8_t a[16], b[16];
+    TEST_ASSERT_TRUE(g.generate(a));
+    auto t0 = std::chrono::steady_clock::now();
+    TEST_ASSERT_TRUE(g.generate(b)); // Overflows, sleeps to the next ms
+    auto waited = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - t0).count();
+    TEST_ASSERT_TRUE(waited < 100);
+    TEST_ASSERT_TRUE(memcmp(a, b, 16) < 0);
+    TEST_ASSERT_EQUAL_INT(2, s_wait_rng_calls);
+
+    // Clock behind the state (minor regression): the counter stays exhausted
+    // until the clock catches up, so the deadline decides.
+    UUID7 s(overflow_rng, nullptr, stepping_now_ms, nullptr);
+    s.setOverflowPolicy(UUID_OVERFLOW_WAIT);
+    s.setOverflowTimeout(5);
+    TEST_ASSERT_EQUAL_INT(5, (int)s.getOverflowTimeout());
+    stepping_time_val = 60000;
+    TEST_ASSERT_TRUE(s.generate());
+    stepping_time_val = 59000;
+    TEST_ASSERT_FALSE(s.generate());
+    TEST_ASSERT_TRUE(stepping_time_val <= 59000 + 10);
+    UUID7Range r;
+    TEST_ASSERT_FALSE(s.reserve(1, r));
 }
 
+/** @brief Verifies the v4 engine takes no lock, mixes entropy and stamps every slot. */
+void test_v4_fast_path() {
+    mock_rng_val = 0x10;
+    UUID7 g(deterministic_rng, nullptr, nullptr, nullptr);
+    g.setVersion(UUID_VERSION_4);
+    g.mixEntropy(0x0102030405060708ULL);
+    s_lock_count = s_unlock_count = 0;
+    g.setLockCallbacks(counting_lock, counting_unlock);
+
+    uint8_t ids[32][16];
+    uint8_t raw[32][16];
+    mock_rng_val = 0x10;
+    deterministic_rng(&raw[0][0], sizeof(raw), nullptr);
+    mock_rng_val = 0x10;
+    TEST_ASSERT_EQUAL_INT(32, (int)g.generateBatch(ids, 32));
+#if defined(UUID7_HAS_ATOMIC64)
+    TEST_ASSERT_EQUAL_INT(0, s_lock_count);
+#endif
+    for (int i = 0; i < 32; i++) {
+        TEST_ASSERT_EQUAL_UINT8(0x40, ids[i][6] & 0xF0);
+        TEST_ASSERT_EQUAL_UINT8(0x80, ids[i][8] & 0xC0);
+        TEST_ASSERT_EQUAL_MEMORY(raw[i], ids[i], 6);
+        TEST_ASSERT_EQUAL_UINT8(raw[i][9] ^ 0x07, ids[i][9]);
+        TEST_ASSERT_EQUAL_UINT8(raw[i][15] ^ 0x01, ids[i][15]);
+    }
+
+    // generate(out) leaves data() alone; generate() publishes
+    uint8_t before[16], id[16];
+    memcpy(before, g.data(), 16);
+    TEST_ASSERT_TRUE(g.generate(id));
+    TEST_ASSERT_EQUAL_MEMORY(before, g.data(), 16);
+    TEST_ASSERT_TRUE(g.generate());
+    TEST_ASSERT_TRUE(g.isV4());
+    TEST_ASSERT_TRUE(g.isValid());
+
+    // A stuck RNG is still rejected
+    UUID7 bad(failing_rng, nullptr, nullptr, nullptr);
+    bad.setVersion(UUID_VERSION_4);
+    TEST_ASSERT_EQUAL_INT(0, (int)bad.generateBatch(ids, 4));
+}
+
+/** @brief Verifies UUID7Key ordering, hashing and round-trips. */
+void test_uuid7_key() {
+    mock_time_val = 0x0123456789ABULL;
+    UUID7 g(nullptr, nullptr, mock_now_ms, nullptr);
+    uint8_t a[16], b[16], back[16];
+    TEST_ASSERT_TRUE(g.generate(a));
+    TEST_ASSERT_TRUE(g.generate(b));
+    UUID7Key ka = UUID7Key::fromBytes(a), kb = UUID7Key::fromBytes(b);
+    ka.toBytes(back);
+    TEST_ASSERT_EQUAL_MEMORY(a, back, 16);
+    TEST_ASSERT_TRUE(ka.timestamp() == 0x0123456789ABULL);
+    TEST_ASSERT_EQUAL_UINT8(7, ka.version());
+    TEST_ASSERT_TRUE(ka < kb && kb > ka && ka != kb && ka <= ka);
+    TEST_ASSERT_EQUAL_INT(-1, UUID7Key::compare(ka, kb));
+    TEST_ASSERT_EQUAL_INT(1, UUID7Key::compare(kb, ka));
+    TEST_ASSERT_EQUAL_INT(0, UUID7Key::compare(ka, UUID7Key::fromBytes(a)));
+    TEST_ASSERT_TRUE(ka.hash() != kb.hash());
+    TEST_ASSERT_TRUE(std::hash<UUID7Key>()(ka) == (size_t)ka.hash());
+
+    // Word order matches memcmp order, including the low half
+    uint8_t x[16] = {0}, y[16] = {0};
+    x[15] = 0x01;
+    y[8] = 0x80;
+    TEST_ASSERT_TRUE(UUID7Key::fromBytes(x) < UUID7Key::fromBytes(y));
+    TEST_ASSERT_TRUE(memcmp(x, y, 16) < 0);
+    TEST_ASSERT_TRUE(UUID7Key::minForTimestamp(5) < UUID7Key::maxForTimestamp(5));
+    TEST_ASSERT_TRUE(UUID7Key::maxForTimestamp(5) < UUID7Key::minForTimestamp(6));
+}
+
+/** @brief Verifies UUID7Index ordering, duplicates, capacity and time-range scans. */
+void test_uuid7_index() {
+    static UUID7Key storage[600];
+    UUID7Index idx(storage, 600);
+    uint8_t id[16];
+
+    // 100 IDs in each of 5 milliseconds
+    mock_time_val = 1000;
+    UUID7 g(nullptr, nullptr, mock_now_ms, nullptr);
+    UUID7Key late;
+    for (int ms = 0; ms < 5; ms++) {
+        for (int i = 0; i < 100; i++) {
+            TEST_ASSERT_TRUE(g.generate(id));
+            if (ms == 2 && i == 50) {
+                late = UUID7Key::fromBytes(id); // Inserted out of order below
+                continue;
+            }
+            TEST_ASSERT_TRUE(idx.insert(id));
+        }
+        mock_time_val++;
+    }
+    TEST_ASSERT_EQUAL_INT(499, (int)idx.size());
+    TEST_ASSERT_FALSE(idx.contains(late));
+    TEST_ASSERT_TRUE(idx.insert(late));
+    TEST_ASSERT_FALSE(idx.insert(late)); // Duplicate
+    TEST_ASSERT_TRUE(idx.contains(late));
+    for (size_t i = 1; i < idx.size(); i++) TEST_ASSERT_TRUE(idx[i - 1] < idx[i]);
+
+    TEST_ASSERT_EQUAL_INT(100, (int)idx.countBetween(1002, 1002));
+    TEST_ASSERT_EQUAL_INT(300, (int)idx.countBetween(1001, 1003));
+    TEST_ASSERT_EQUAL_INT(500, (int)idx.countBetween(0, 0x0000FFFFFFFFFFFFULL));
+    TEST_ASSERT_EQUAL_INT(0, (int)idx.countBetween(2000, 3000));
+    TEST_ASSERT_EQUAL_INT(0, (int)idx.countBetween(1003, 1001));
+    size_t seen = 0;
+    for (const UUID7Key& k : idx.between(1004, 1004)) {
+        TEST_ASSERT_TRUE(k.timestamp() == 1004);
+        seen++;
+    }
+    TEST_ASSERT_EQUAL_INT(100, (int)seen);
+
+    TEST_ASSERT_TRUE(idx.erase(late));
+    TEST_ASSERT_FALSE(idx.erase(late));
+    TEST_ASSERT_EQUAL_INT(99, (int)idx.countBetween(1002, 1002));
+    TEST_ASSERT_EQUAL_INT(200, (int)idx.eraseBefore(1002));
+    TEST_ASSERT_TRUE(idx[0].timestamp() == 1002);
+    TEST_ASSERT_EQUAL_INT(299, (int)idx.size());
+
+    // Full index rejects inserts
+    UUID7Key small[2];
+    UUID7Index tiny(small, 2);
+    TEST_ASSERT_TRUE(tiny.insert(UUID7Key(2, 0)));
+    TEST_ASSERT_TRUE(tiny.insert(UUID7Key(1, 0)));
+    TEST_ASSERT_FALSE(tiny.insert(UUID7Key(3, 0)));
+    TEST_ASSERT_TRUE(tiny[0] == UUID7Key(1, 0));
+}
+
+/** @brief Verifies uuid7::Id layout, generate() overloads, ordering and formatting. */
+void test_id_value_type() {
+    TEST_ASSERT_EQUAL_INT(16, (int)sizeof(uuid7::Id));
+    TEST_ASSERT_TRUE(std::is_trivially_copyable<uuid7::Id>::value);
+    static constexpr uuid7::Id fixed(0x0190A1B2C3D47E5FULL, 0x8123456789ABCDEFULL);
+    TEST_ASSERT_EQUAL_UINT8(0x01, fixed.b[0]);
+    TEST_ASSERT_EQUAL_UINT8(0xEF, fixed.b[15]);
+    TEST_ASSERT_EQUAL_UINT8(7, fixed.version());
+    TEST_ASSERT_TRUE(fixed.timestamp() == 0x0190A1B2C3D4ULL);
+    TEST_ASSERT_TRUE(uuid7::Id::nil().isNil());
+    TEST_ASSERT_FALSE(fixed.isNil());
+
+    char str[37];
+    TEST_ASSERT_TRUE(fixed.toString(str, sizeof(str)));
+    TEST_ASSERT_EQUAL_STRING("0190a1b2-c3d4-7e5f-8123-456789abcdef", str);
+    TEST_ASSERT_FALSE(fixed.toString(str, 36));
+    uuid7::Id parsed;
+    TEST_ASSERT_TRUE(uuid7::Id::parse(str, parsed));
+    TEST_ASSERT_TRUE(parsed == fixed);
+    TEST_ASSERT_FALSE(uuid7::Id::parse("0190a1b2-c3d4-7e5f-8123-456789abcdeg", parsed));
+    TEST_ASSERT_TRUE(uuid7::Id::fromKey(fixed.key()) == fixed);
+    TEST_ASSERT_TRUE(fixed.hash() == fixed.key().hash());
+    TEST_ASSERT_TRUE(std::hash<uuid7::Id>()(fixed) == (size_t)fixed.hash());
+
+    mock_time_val = 5000;
+    UUID7 g(nullptr, nullptr, mock_now_ms, nullptr);
+    uuid7::Id ids[8];
+    for (int i = 0; i < 8; i++) TEST_ASSERT_TRUE(g.generate(ids[i]));
+    for (int i = 1; i < 8; i++) TEST_ASSERT_TRUE(ids[i - 1] < ids[i]);
+    TEST_ASSERT_TRUE(g.id() == ids[7]);
+    TEST_ASSERT_EQUAL_MEMORY(g.data(), ids[7].data(), 16);
+    uuid7::Id next = g.generateId();
+    TEST_ASSERT_TRUE(next > ids[7]);
+    TEST_ASSERT_TRUE(next.timestamp() == 5000);
+
+    mock_time_val = 0; // Clock failure
+    TEST_ASSERT_TRUE(g.generateId().isNil());
+}
+
+/** @brief Verifies the constexpr codec path and the _uuid7 literal. */
+void test_constexpr_literal() {
+    using namespace uuid7::literals;
+    static constexpr uuid7::Id ns = "0190a1b2-c3d4-7e5F-8123-456789ABCDEF"_uuid7;
+    static constexpr uuid7::Id plain = "0190a1b2c3d47e5f8123456789abcdef"_uuid7;
+    static_assert(ns.b[0] == 0x01 && ns.b[6] == 0x7E && ns.b[15] == 0xEF,
+                  "literal decoded at compile time");
+    static_assert(plain.b[8] == 0x81, "undashed literal decoded at compile time");
+    static_assert(UUID7Codec::isValid("0190a1b2-c3d4-7e5f-8123-456789abcdef", 36), "");
+    static_assert(!UUID7Codec::isValid("0190a1b2-c3d4-7e5f-8123-456789abcdeg", 36), "");
+    static_assert(!UUID7Codec::isValid("0190a1b2+c3d4-7e5f-8123-456789abcdef", 36), "");
+    static_assert(!UUID7Codec::isValid("0190a1b2c3d4", 12), "");
+    TEST_ASSERT_TRUE(ns == plain);
+
+    uint8_t rt[16];
+    TEST_ASSERT_TRUE(UUID7Codec::decode("0190a1b2-c3d4-7e5f-8123-456789abcdef", rt));
+    TEST_ASSERT_EQUAL_MEMORY(rt, ns.data(), 16);
+    TEST_ASSERT_EQUAL_STRING("0190a1b2-c3d4-7e5f-8123-456789abcdef", ns.str().c_str());
+    TEST_ASSERT_EQUAL_STRING("0190A1B2-C3D4-7E5F-8123-456789ABCDEF", ns.str(true).c_str());
+#if defined(__cpp_constexpr) && __cpp_constexpr >= 201304L
+    static constexpr uuid7::IdString cs = ns.str();
+    static_assert(cs.s[8] == '-' && cs.s[35] == 'f', "str() formats at compile time");
+#endif
+
+    // Run-time use of a malformed string yields nil instead of garbage
+    const char *bad = "0190a1b2-c3d4-7e5f-8123-456789abcdeX";
+    TEST_ASSERT_TRUE(uuid7::Id::fromString(bad, strlen(bad)).isNil());
+}
+
+/** @brief Verifies UUID7Scanner matches, word boundaries and chunk-boundary carry. */
+void test_scanner() {
+    static const char text[] =
+        "{\"id\":\"0190a1b2-c3d4-7e5f-8123-456789abcdef\",\"ref\":\"0190A1B2C3D47E5F8123456789ABCDEF\"}\n"
+        "c0190a1b2-c3d4-7e5f-8123-456789abcdef,"        // hex before: no match
+        "0190a1b2-c3d4-7e5f-8123-456789abcdef0,"        // hex after: no match
+        "0190a1b2c3d47e5f8123456789abcdef1,"            // 33 digits: no match
+        "0190a1b2-c3d4-7e5f-8123-456789abcdeg,"         // bad digit: no match
+        "0190a1b2-c3d4-7e5f+8123-456789abcdef,"         // bad dash: no match
+        "ffffffff-ffff-4fff-bfff-ffffffffffff";         // at end of stream
+    const size_t len = sizeof(text) - 1;
+    UUID7Scanner::Match m[8];
+    size_t n = UUID7Scanner::scan(text, len, m, 8);
+    TEST_ASSERT_EQUAL_INT(3, (int)n);
+
+    static constexpr uuid7::Id expect(0x0190A1B2C3D47E5FULL, 0x8123456789ABCDEFULL);
+    TEST_ASSERT_TRUE(m[0].id == expect);
+    TEST_ASSERT_EQUAL_INT(7, (int)m[0].offset);
+    TEST_ASSERT_EQUAL_INT(36, m[0].length);
+    TEST_ASSERT_TRUE(m[1].id == expect);
+    TEST_ASSERT_EQUAL_INT(32, m[1].length);
+    TEST_ASSERT_EQUAL_MEMORY("0190A1B2C3D47E5F", text + m[1].offset, 16);
+    TEST_ASSERT_EQUAL_INT((int)(len - 36), (int)m[2].offset);
+    TEST_ASSERT_EQUAL_UINT8(0x4F, m[2].id.b[6]);
+
+    TEST_ASSERT_EQUAL_INT(2, (int)UUID7Scanner::scan(text, len, m, 8, UUID7Scanner::DASHED));
+    TEST_ASSERT_EQUAL_INT(1, (int)UUID7Scanner::scan(text, len, m, 8, UUID7Scanner::UNDASHED));
+    TEST_ASSERT_EQUAL_INT(1, (int)UUID7Scanner::scan(text, len, m, 1));
+
+    // Every chunk size must give the same matches and offsets as one pass
+    UUID7Scanner::Match ref[8];
+    UUID7Scanner::scan(text, len, ref, 8);
+    for (size_t chunk = 1; chunk <= len; chunk++) {
+        UUID7Scanner s;
+        UUID7Scanner::Match got;
+        size_t found = 0;
+        for (size_t off = 0; off < len; off += chunk) {
+            s.feed(text + off, (len - off) < chunk ? (len - off) : chunk);
+            while (s.next(got)) {
+                TEST_ASSERT_TRUE(found < 3);
+                TEST_ASSERT_TRUE(got.id == ref[found].id);
+                TEST_ASSERT_TRUE(got.offset == ref[found].offset);
+                found++;
+            }
+        }
+        s.finish();
+        while (s.next(got)) {
+            TEST_ASSERT_TRUE(got.id == ref[found].id && got.offset == ref[found].offset);
+            found++;
+        }
+        TEST_ASSERT_EQUAL_INT(3, (int)found);
+    }
+}
+
+/** @brief Verifies UUID7Bulk timestamp extraction, classification and bucketing. */
+void test_bulk_helpers() {
+    static uint8_t ids[301][16];
+    mock_time_val = 1700000000000ULL;
+    UUID7 g(nullptr, nullptr, mock_now_ms, nullptr);
+    for (int i = 0; i < 300; i++) {
+        mock_time_val = 1700000000000ULL + (uint64_t)(i / 10) * 7; // 10 IDs every 7 ms
+        TEST_ASSERT_TRUE(g.generate(ids[i]));
+    }
+    memset(ids[300], 0xFF, 16); // Variant 0b11: not RFC
+
+    uint64_t ts[301];
+    UUID7Bulk::timestamps(ids, 301, ts);
+    for (int i = 0; i < 300; i++) {
+        TEST_ASSERT_TRUE(ts[i] == 1700000000000ULL + (uint64_t)(i / 10) * 7);
+        TEST_ASSERT_TRUE(ts[i] == UUID7Bulk::timestamp(ids[i]));
+    }
+    TEST_ASSERT_TRUE(ts[300] == 0xFFFFFFFFFFFFULL);
+
+    uint8_t v4[16];
+    UUID7 g4;
+    g4.setVersion(UUID_VERSION_4);
+    TEST_ASSERT_TRUE(g4.generate(v4));
+    memcpy(ids[0], v4, 16);
+    uint8_t ver[301];
+    UUID7Bulk::versions(ids, 301, ver);
+    TEST_ASSERT_EQUAL_UINT8(4, ver[0]);
+    TEST_ASSERT_EQUAL_UINT8(7, ver[1]);
+    TEST_ASSERT_EQUAL_UINT8(0, ver[300]);
+    TEST_ASSERT_EQUAL_INT(299, (int)UUID7Bulk::countVersion(ids, 301));
+    TEST_ASSERT_EQUAL_INT(1, (int)UUID7Bulk::countVersion(ids, 301, 4));
+
+    // 7 ms buckets (division path): one bucket per group of 10
+    uint32_t counts[40];
+    memset(counts, 0, sizeof(counts));
+    size_t counted = UUID7Bulk::histogram(ids, 301, 1700000000000ULL, 7, counts, 40);
+    TEST_ASSERT_EQUAL_INT(299, (int)counted);
+    TEST_ASSERT_EQUAL_INT(9, (int)counts[0]); // ids[0] is now v4
+    for (int k = 1; k < 30; k++) TEST_ASSERT_EQUAL_INT(10, (int)counts[k]);
+    TEST_ASSERT_EQUAL_INT(0, (int)counts[30]);
+
+    // 64 ms buckets (shift path), window starting mid-run, accumulated twice
+    uint32_t wide[2] = {0, 0};
+    const uint64_t start = 1700000000000ULL + 70;
+    TEST_ASSERT_EQUAL_INT(190, (int)UUID7Bulk::histogram(ids, 301, start, 64, wide, 2));
+    UUID7Bulk::histogram(ids, 301, start, 64, wide, 2);
+    // [70, 134): groups 10..19; [134, 198): groups 20..28
+    TEST_ASSERT_EQUAL_INT(200, (int)wide[0]);
+    TEST_ASSERT_EQUAL_INT(180, (int)wide[1]);
+    TEST_ASSERT_EQUAL_INT(0, (int)UUID7Bulk::histogram(ids, 301, start, 0, wide, 2));
+}
+
+/** @brief Top 14 bits of rand_b. */
+static uint16_t node14(const uint8_t b[16]) {
+    return (uint16_t)(((b[8] & 0x3F) << 8) | b[9]);
+}
+
+/** @brief Verifies setNodeId(): disjoint node prefixes, overflow and reconfiguration. */
+void test_node_id() {
+    UUID7 a(deterministic_rng, nullptr, mock_now_ms, nullptr);
+    UUID7 b(deterministic_rng, nullptr, mock_now_ms, nullptr);
+    TEST_ASSERT_FALSE(a.setNodeId(0x4000, 14)); // Does not fit
+    TEST_ASSERT_FALSE(a.setNodeId(1, 29));
+    TEST_ASSERT_TRUE(a.setNodeId(9999, 14));
+    TEST_ASSERT_TRUE(b.setNodeId(10000, 14));
+    TEST_ASSERT_EQUAL_INT(14, a.getNodeBits());
+    TEST_ASSERT_TRUE(a.getNodeId() == 9999);
+
+    // Same clock, same RNG stream: only the node bits tell them apart
+    mock_time_val = 50000;
+    uint8_t ia[16], ib[16], prev[16];
+    mock_rng_val = 0x20;
+    TEST_ASSERT_TRUE(a.generate(ia));
+    mock_rng_val = 0x20;
+    TEST_ASSERT_TRUE(b.generate(ib));
+    TEST_ASSERT_TRUE(memcmp(ia, ib, 16) != 0);
+    TEST_ASSERT_EQUAL_INT(9999, node14(ia));
+    TEST_ASSERT_EQUAL_INT(10000, node14(ib));
+    TEST_ASSERT_EQUAL_MEMORY(ia, ib, 8);
+
+    // The counter below the prefix keeps order; the prefix never changes
+    a.setCounterSeedBits(40);
+    mock_time_val++;
+    TEST_ASSERT_TRUE(a.generate(prev));
+    for (int i = 0; i < 2000; i++) {
+        TEST_ASSERT_TRUE(a.generate(ia));
+        TEST_ASSERT_TRUE(memcmp(prev, ia, 16) < 0);
+        TEST_ASSERT_EQUAL_INT(9999, node14(ia));
+        memcpy(prev, ia, 16);
+    }
+
+    // Changing the node ID restarts one millisecond ahead
+    TEST_ASSERT_TRUE(a.setNodeId(77, 14));
+    TEST_ASSERT_TRUE(a.generate(ia));
+    TEST_ASSERT_TRUE(memcmp(prev, ia, 16) < 0);
+    TEST_ASSERT_EQUAL_INT(77, node14(ia));
+    TEST_ASSERT_TRUE(UUID7Bulk::timestamp(ia) == mock_time_val + 1);
+    TEST_ASSERT_TRUE(a.setNodeId(0, 0));
+    TEST_ASSERT_EQUAL_INT(0, a.getNodeBits());
+
+    // A carry into the node bits is an overflow
+    UUID7 sat(overflow_rng, nullptr, mock_now_ms, nullptr);
+    TEST_ASSERT_TRUE(sat.setNodeId(5, 14));
+    TEST_ASSERT_TRUE(sat.generate(ia));
+    TEST_ASSERT_EQUAL_INT(5, node14(ia));
+    TEST_ASSERT_FALSE(sat.generate(ia));
+
+    // Shard index sits below the node ID
+    static UUID7Sharded<4> sharded(nullptr, nullptr, mock_now_ms, nullptr);
+    TEST_ASSERT_FALSE(sharded.setNodeId(1, 27)); // 27 + 2 shard bits > 28
+    TEST_ASSERT_TRUE(sharded.setNodeId(0x2AAA, 14));
+    TEST_ASSERT_TRUE(sharded.generate(3, ia));
+    uint16_t top16 = (uint16_t)((node14(ia) << 2) | (ia[10] >> 6));
+    TEST_ASSERT_EQUAL_INT((0x2AAA << 2) | 3, top16);
+
+#if defined(UUID7_HAS_ATOMIC64)
+    // Lock-free mode: the prefix follows the 4 sequence bits of rand_b
+    UUID7 lf(nullptr, nullptr, mock_now_ms, nullptr);
+    lf.setLockFree(true);
+    TEST_ASSERT_TRUE(lf.setNodeId(0x1234, 14));
+    for (int i = 0; i < 3; i++) {
+        TEST_ASSERT_TRUE(lf.generate(ia));
+        uint32_t w = ((uint32_t)(ia[8] & 0x3F) << 16) | ((uint32_t)ia[9] << 8) | ia[10];
+        TEST_ASSERT_EQUAL_INT(0x1234, (int)((w >> 4) & 0x3FFF));
+    }
+#endif
+}
+
+/**
+ * @brief Verifies UUID7ISR: no IDs before begin(), strictly increasing IDs
+ * per tick, the 4096-per-ms budget, ignored backward ticks, the node prefix
+ * and uniqueness under concurrent generators and a ticking thread.
+ */
+void test_isr_generate() {
+    // Hosts reserve with a real atomic, never a plain increment
+    TEST_ASSERT_TRUE(UUID7ISR<>::kAtomicReservation);
+    TEST_ASSERT_FALSE(UUID7ISR<>::kMaskedReservation);
+    uint8_t id[16], prev[16];
+    static UUID7ISR<> isr(deterministic_rng, nullptr);
+    TEST_ASSERT_FALSE(isr.generateFromISR(id));
+    TEST_ASSERT_FALSE(isr.setNodeId(0x4000, 14));
+    TEST_ASSERT_TRUE(isr.setNodeId(321, 14));
+    mock_rng_val = 0x10;
+    TEST_ASSERT_TRUE(isr.begin(70000));
+    TEST_ASSERT_TRUE(isr.lastTick() == 70000);
+
+    TEST_ASSERT_TRUE(isr.generateFromISR(prev));
+    for (uint32_t i = 1; i < UUID7ISR<>::kPerMs; i++) {
+        TEST_ASSERT_TRUE(isr.generateFromISR(id));
+        TEST_ASSERT_TRUE(memcmp(prev, id, 16) < 0);
+        memcpy(prev, id, 16);
+    }
+    TEST_ASSERT_EQUAL_INT(7, id[6] >> 4);
+    TEST_ASSERT_EQUAL_INT(0x80, id[8] & 0xC0);
+    TEST_ASSERT_EQUAL_INT(321, node14(id));
+    TEST_ASSERT_TRUE(UUID7Bulk::timestamp(id) == 70000);
+    TEST_ASSERT_FALSE(isr.generateFromISR(id)); // Budget used up
+
+    isr.tick(69000); // Backwards: ignored
+    TEST_ASSERT_FALSE(isr.generateFromISR(id));
+    isr.tick(70001);
+    TEST_ASSERT_TRUE(isr.generateFromISR(id));
+    TEST_ASSERT_TRUE(memcmp(prev, id, 16) < 0);
+    TEST_ASSERT_TRUE(UUID7Bulk::timestamp(id) == 70001);
+
+    // A failing RNG never marks the pool ready
+    static UUID7ISR<4> dead(failing_rng, nullptr);
+    TEST_ASSERT_FALSE(dead.begin(70000));
+    TEST_ASSERT_FALSE(dead.generateFromISR(id));
+
+#if defined(UUID7_HAS_ATOMIC64)
+    static UUID7ISR<> shared(deterministic_rng, nullptr);
+    TEST_ASSERT_TRUE(shared.begin(80000));
+    const int kThreads = 4, kPerThread = 3000;
+    std::vector<std::vector<uuid7::Id>> got(kThreads);
+    std::atomic<bool> stop(false);
+    std::thread ticker([&]() {
+        uint64_t ms = 80000;
+        while (!stop.load())
+            shared.tick(++ms);
+    });
+    std::vector<std::thread> workers;
+    for (int t = 0; t < kThreads; t++) {
+        workers.push_back(std::thread([&got, t, kPerThread]() {
+            uuid7::Id x;
+            while ((int)got[t].size() < kPerThread) {
+                if (shared.generateFromISR(x.b))
+                    got[t].push_back(x);
+            }
+        }));
+    }
+    for (auto &w : workers) w.join();
+    stop = true;
+    ticker.join();
+
+    std::vector<uuid7::Id> all;
+    for (int t = 0; t < kThreads; t++) {
+        for (size_t k = 1; k < got[t].size(); k++)
+            TEST_ASSERT_TRUE(got[t][k - 1] < got[t][k]); // Per-caller order
+        all.insert(all.end(), got[t].begin(), got[t].end());
+    }
+    std::sort(all.begin(), all.end());
+    TEST_ASSERT_TRUE(std::adjacent_find(all.begin(), all.end()) == all.end());
+#endif
+}
+
+/**
+ * @brief Verifies UUID7Prefetcher: FIFO order of generator output, the
+ * low-watermark refill, misses on an empty ring, the persisted high-water
+ * mark covering queued IDs, and a background producer thread.
+ */
+void test_prefetcher() {
+    mock_nvs_storage = 0;
+    mock_time_val = 90000;
+    UUID7 g(nullptr, nullptr, mock_now_ms, nullptr);
+    g.setStorage(mock_load_fn, mock_save_fn, nullptr, 1000);
+    UUID7Prefetcher<8> pf(g, 3);
+    uint8_t id[16], prev[16];
+    TEST_ASSERT_FALSE(pf.pop(id));
+    TEST_ASSERT_TRUE(pf.misses() == 1);
+    TEST_ASSERT_EQUAL_INT(0, (int)pf.size());
+
+    TEST_ASSERT_EQUAL_INT(8, (int)pf.fill());
+    TEST_ASSERT_TRUE(mock_nvs_storage >= 90000); // Saved before consumption
+    TEST_ASSERT_EQUAL_INT(0, (int)pf.service()); // Full: above the watermark
+
+    TEST_ASSERT_TRUE(pf.pop(prev));
+    for (int i = 0; i < 4; i++) {
+        TEST_ASSERT_TRUE(pf.pop(id));
+        TEST_ASSERT_TRUE(memcmp(prev, id, 16) < 0);
+        memcpy(prev, id, 16);
+    }
+    TEST_ASSERT_EQUAL_INT(3, (int)pf.size());
+    TEST_ASSERT_EQUAL_INT(5, (int)pf.service()); // At the watermark: top up across the wrap
+    for (int i = 0; i < 8; i++) {
+        TEST_ASSERT_TRUE(i % 2 ? pf.popFromISR(id) : pf.pop(id));
+        TEST_ASSERT_TRUE(memcmp(prev, id, 16) < 0);
+        memcpy(prev, id, 16);
+    }
+    TEST_ASSERT_TRUE(pf.empty());
+    TEST_ASSERT_FALSE(pf.popFromISR(id));
+    TEST_ASSERT_TRUE(pf.misses() == 2);
+
+    // The generator continues after the last queued ID
+    TEST_ASSERT_TRUE(g.generate(id));
+    TEST_ASSERT_TRUE(memcmp(prev, id, 16) < 0);
+
+#if defined(UUID7_PREFETCH_TASK)
+    static UUID7 live;
+    static UUID7Prefetcher<64> bg(live, 16);
+    // Racing start() calls: exactly one claims the producer
+    std::atomic<int> started(0);
+    std::vector<std::thread> starters;
+    for (int t = 0; t < 4; t++)
+        starters.emplace_back([&]() { if (bg.start()) started++; });
+    for (auto &t : starters)
+        t.join();
+    TEST_ASSERT_EQUAL_INT(1, started.load());
+    TEST_ASSERT_FALSE(bg.start());
+    uuid7::Id a = uuid7::Id::nil(), b;
+    for (int got = 0; got < 20000;) {
+        if (!bg.pop(b))
+            continue;
+        TEST_ASSERT_TRUE(a < b);
+        a = b;
+        got++;
+    }
+    bg.stop();
+#endif
+}
+
+#if defined(UUID7_HAS_ATOMIC64)
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <algorithm>
+
+/**
+ * @brief Verifies the lock-free mode: no guard on generate(out), strict
+ * monotonicity within one ms, and the 16-bit sequence budget per ms.
+ */
+void test_lock_free_mode() {
+    s_lock_count = s_unlock_count = 0;
+    mock_time_val = 424242;
+
+    UUID7 g(nullptr, nullptr, mock_now_ms, nullptr);
+    g.setLockCallbacks(counting_lock, counting_unlock);
+    g.setLockFree(true);
+    TEST_ASSERT_TRUE(g.isLockFree());
+    int locks = s_lock_count;
+
+    uint8_t prev[16], cur[16];
+    TEST_ASSERT_TRUE(g.generate(prev));
+    for (int i = 0; i < 1000; i++) {
+        TEST_ASSERT_TRUE(g.generate(cur));
+        TEST_ASSERT_TRUE(memcmp(prev, cur, 16) < 0);
+        memcpy(prev, cur, 16);
+    }
+    TEST_ASSERT_EQUAL_INT(locks, s_lock_count); // never locked
+    TEST_ASSERT_EQUAL_UINT8(7, (cur[6] >> 4) & 0x0F);
+    TEST_ASSERT_EQUAL_UINT8(2, (cur[8] >> 6) & 0x03);
+
+    // generate() still publishes into the internal buffer
+    TEST_ASSERT_TRUE(g.generate());
+    TEST_ASSERT_TRUE(g.getTimestamp() == 424242);
+
+    // Exhaust the 65536-entry sequence of a fresh millisecond
+    mock_time_val = 424243;
+    uint8_t batch[256][16];
+    size_t total = 0;
+    while (true) {
+        size_t got = g.generateBatch(batch, 256);
+        total += got;
+        if (got > 0) memcpy(prev, batch[got - 1], 16);
+        if (got < 256) break;
+    }
+    TEST_ASSERT_TRUE(total == 65536);
+    TEST_ASSERT_FALSE(g.generate(cur));
+
+    // Switching back keeps the sequence monotonic
+    g.setLockFree(false);
+    TEST_ASSERT_FALSE(g.isLockFree());
+    TEST_ASSERT_TRUE(g.generate(cur));
+    TEST_ASSERT_TRUE(memcmp(prev, cur, 16) < 0);
+}
+
+/**
+ * @brief Verifies the native RNG backends: healthy OS output and distinct
+ * draws from the per-thread default stream across concurrent threads.
+ */
+void test_native_rng() {
+    struct Key { uint8_t b[16]; bool operator<(const Key& o) const { return memcmp(b, o.b, 16) < 0; } };
+    Key os_a, os_b;
+    UUID7::os_fill_random(os_a.b, 16, nullptr);
+    UUID7::os_fill_random(os_b.b, 16, nullptr);
+    TEST_ASSERT_TRUE(memcmp(os_a.b, os_b.b, 16) != 0);
+
+    const int kThreads = 4, kPerThread = 2000;
+    std::vector<Key> draws(kThreads * kPerThread);
+    std::vector<std::thread> workers;
+    for (int t = 0; t < kThreads; t++) {
+        workers.push_back(std::thread([&draws, t, kPerThread]() {
+            for (int i = 0; i < kPerThread; i++) {
+                UUID7::default_fill_random(draws[t * kPerThread + i].b, 16, nullptr);
+            }
+        }));
+    }
+    for (size_t t = 0; t < workers.size(); t++) workers[t].join();
+    std::sort(draws.begin(), draws.end());
+    for (size_t i = 1; i < draws.size(); i++) {
+        TEST_ASSERT_TRUE(memcmp(draws[i - 1].b, draws[i].b, 16) != 0);
+    }
+}
+
+#if defined(UUID7_HAS_SEQLOCK)
+static uint64_t s_seq_calls = 0;
+static uint64_t seq_now_ms(void*) { return 1000000 + s_seq_calls; }
+static void seq_rng(uint8_t* dest, size_t len, void*) {
+    memset(dest, (int)(s_seq_calls % 200) + 1, len);
+    s_seq_calls++;
+}
+
+/**
+ * @brief Verifies that seqlock readers never observe a torn UUID while a
+ * writer publishes new IDs.
+ */
+void test_seqlock_readers() {
+    s_seq_calls = 0;
+    UUID7 g(seq_rng, nullptr, seq_now_ms, nullptr);
+    TEST_ASSERT_TRUE(g.generate());
+    std::atomic<bool> stop(false);
+    std::thread writer([&]() {
+        for (int i = 0; i < 200000; i++) (void)g.generate();
+        stop = true;
+    });
+    int torn = 0, reads = 0;
+    while (!stop) {
+        char buf[37];
+        uint8_t b[16];
+        g.toString(buf, sizeof(buf));
+        UUID7::parseFromString(buf, b);
+        uint64_t ts = 0;
+        for (int i = 0; i < 6; i++) ts = (ts << 8) | b[i];
+        // ts and the random tail come from the same generate() call
+        uint8_t expect = (uint8_t)((ts - 1000001) % 200 + 1);
+        for (int i = 9; i < 16; i++) torn += (b[i] != expect);
+        reads++;
+    }
+    writer.join();
+    TEST_ASSERT_TRUE(reads > 0);
+    TEST_ASSERT_EQUAL_INT(0, torn);
+}
+#endif
+
+/**
+ * @brief Verifies uniqueness of lock-free IDs generated concurrently.
+ */
+void test_lock_free_concurrency() {
+    struct Key { uint8_t b[16]; bool operator<(const Key& o) const { return memcmp(b, o.b, 16) < 0; } };
+    const int kThreads = 4, kPerThread = 5000;
+    UUID7 g;
+    g.setLockFree(true);
+    std::vector<Key> ids(kThreads * kPerThread);
+    std::vector<std::thread> workers;
+    for (int t = 0; t < kThreads; t++) {
+        workers.push_back(std::thread([&g, &ids, t, kPerThread]() {
+            for (int i = 0; i < kPerThread; i++) {
+                while (!g.generate(ids[t * kPerThread + i].b)) {}
+            }
+        }));
+    }
+    for (size_t t = 0; t < workers.size(); t++) workers[t].join();
+    std::sort(ids.begin(), ids.end());
+    for (size_t i = 1; i < ids.size(); i++) {
+        TEST_ASSERT_TRUE(memcmp(ids[i - 1].b, ids[i].b, 16) < 0);
+    }
+}
+#endif
+
+/**
+ * @brief Verifies shard bit placement, per-shard monotonicity and that a
+ * lagging shard follows the shared millisecond high-water mark.
+ */
+void test_sharded_generator() {
+    mock_time_val = 50000;
+    UUID7Sharded<4> sh(nullptr, nullptr, mock_now_ms, nullptr);
+    TEST_ASSERT_TRUE(UUID7Sharded<4>::shardCount() == 4);
+
+    uint8_t ids[4][3][16];
+    for (int round = 0; round < 3; round++) {
+        for (size_t s = 0; s < 4; s++) {
+            TEST_ASSERT_TRUE(sh.generate(s, ids[s][round]));
+            // Shard index lives in the top 2 bits of rand_b
+            TEST_ASSERT_EQUAL_UINT8(s, (ids[s][round][8] >> 4) & 0x03);
+            TEST_ASSERT_EQUAL_UINT8(2, (ids[s][round][8] >> 6) & 0x03);
+            if (round > 0) TEST_ASSERT_TRUE(memcmp(ids[s][round - 1], ids[s][round], 16) < 0);
+        }
+    }
+
+    // A shard that reads an older millisecond follows the high-water mark
+    uint8_t lead[16], lag[16];
+    mock_time_val = 50010;
+    TEST_ASSERT_TRUE(sh.generate(0, lead));
+    mock_time_val = 50005;
+    TEST_ASSERT_TRUE(sh.generate(1, lag));
+    TEST_ASSERT_EQUAL_MEMORY(lead, lag, 6);
+
+    // A shard's own clock setter cannot bypass the mark; the front end's can
+    static uint64_t s_far = 0;
+    sh.shard(1).setTimeProvider([](void*) -> uint64_t { return 40000; });
+    TEST_ASSERT_TRUE(sh.generate(1, lag));
+    TEST_ASSERT_TRUE(UUID7Bulk::timestamp(lag) >= 50010);
+    s_far = 60000;
+    sh.setTimeProvider([](void*) -> uint64_t { return s_far; });
+    TEST_ASSERT_TRUE(sh.generate(2, lag));
+    TEST_ASSERT_TRUE(UUID7Bulk::timestamp(lag) == 60000);
+    sh.setTimeProvider(mock_now_ms);
+
+    // Thread-bound selection
+    uint8_t mine[16];
+    TEST_ASSERT_TRUE(sh.generate(mine));
+    TEST_ASSERT_EQUAL_UINT8(UUID7Sharded<4>::currentShard(), (mine[8] >> 4) & 0x03);
+}
+
+#if defined(UUID7_HAS_ATOMIC64)
+/**
+ * @brief Verifies uniqueness and per-thread ordering across sharded workers.
+ */
+void test_sharded_concurrency() {
+    struct Key { uint8_t b[16]; bool operator<(const Key& o) const { return memcmp(b, o.b, 16) < 0; } };
+    const int kThreads = 4, kPerThread = 5000;
+    UUID7Sharded<4> sh;
+    std::vector<Key> ids(kThreads * kPerThread);
+    std::vector<std::thread> workers;
+    bool ordered[kThreads];
+    for (int t = 0; t < kThreads; t++) {
+        workers.push_back(std::thread([&sh, &ids, &ordered, t, kPerThread]() {
+            ordered[t] = true;
+            for (int i = 0; i < kPerThread; i++) {
+                uint8_t* b = ids[t * kPerThread + i].b;
+                while (!sh.generate(b)) {}
+                if (i > 0 && memcmp(b - 16, b, 16) >= 0) ordered[t] = false;
+            }
+        }));
+    }
+    for (size_t t = 0; t < workers.size(); t++) workers[t].join();
+    for (int t = 0; t < kThreads; t++) TEST_ASSERT_TRUE(ordered[t]);
+    std::sort(ids.begin(), ids.end());
+    for (size_t i = 1; i < ids.size(); i++) {
+        TEST_ASSERT_TRUE(memcmp(ids[i - 1].b, ids[i].b, 16) < 0);
+    }
+}
+#endif
+
 // --- TEST RUNNER ---
 
 void run_tests() {
@@ -811,6 +2461,43 @@ void run_tests() {
     RUN_TEST(test_lock_callbacks);
     RUN_TEST(test_getter_lock_callbacks);
 
+    RUN_TEST(test_generate_batch);
+    RUN_TEST(test_generate_batch_overflow);
+    RUN_TEST(test_entropy_on_tick);
+    RUN_TEST(test_entropy_pool);
+    RUN_TEST(test_codec_paths);
+    RUN_TEST(test_codec_bulk);
+    RUN_TEST(test_compact_encodings);
+    RUN_TEST(test_sub_millisecond_precision);
+    RUN_TEST(test_counter_modes);
+    RUN_TEST(test_deferred_persistence);
+    RUN_TEST(test_storage_lease);
+    RUN_TEST(test_reserve_range);
+    RUN_TEST(test_basic_template);
+    RUN_TEST(test_clock_anchor);
+    RUN_TEST(test_stats);
+    RUN_TEST(test_overflow_wait_deadline);
+    RUN_TEST(test_v4_fast_path);
+    RUN_TEST(test_uuid7_key);
+    RUN_TEST(test_uuid7_index);
+    RUN_TEST(test_id_value_type);
+    RUN_TEST(test_constexpr_literal);
+    RUN_TEST(test_scanner);
+    RUN_TEST(test_bulk_helpers);
+    RUN_TEST(test_node_id);
+    RUN_TEST(test_isr_generate);
+    RUN_TEST(test_prefetcher);
+    RUN_TEST(test_sharded_generator);
+#if defined(UUID7_HAS_ATOMIC64)
+    RUN_TEST(test_lock_free_mode);
+#if defined(UUID7_HAS_SEQLOCK)
+    RUN_TEST(test_seqlock_readers);
+#endif
+    RUN_TEST(test_lock_free_concurrency);
+    RUN_TEST(test_native_rng);
+    RUN_TEST(test_sharded_concurrency);
+#endif
+
     UNITY_END();
 }
 